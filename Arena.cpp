@@ -0,0 +1,84 @@
+// File: Arena.cpp
+// Summary:
+// This file implements the Arena class, the bump allocation over a list of chunks, and the
+// ArenaSet class.
+//
+// Input:
+// - Allocation requests with their sizes and alignments.
+//
+// Output:
+// - Memory inside the arena's chunks.
+//
+#include "Arena.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+void* Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    std::uintptr_t start = (reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    if (cursor == nullptr || start + bytes > reinterpret_cast<std::uintptr_t>(limit)) {
+        addChunk(bytes + alignment);
+        start = (reinterpret_cast<std::uintptr_t>(cursor) + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    }
+    cursor = reinterpret_cast<char*>(start + bytes);
+    allocatedBytes += bytes;
+    return reinterpret_cast<void*>(start);
+}
+
+void Arena::addChunk(std::size_t minimumBytes) {
+    const std::size_t size = std::max(nextChunkBytes, minimumBytes + sizeof(Chunk));
+    void* memory = std::malloc(size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    last = new (memory) Chunk{last, size};
+    cursor = static_cast<char*>(memory) + sizeof(Chunk);
+    limit = static_cast<char*>(memory) + size;
+    chunkBytes += size;
+    ++chunks;
+    nextChunkBytes = std::min(maximumChunkBytes, std::max(nextChunkBytes, size) * 2);
+}
+
+void Arena::reserve(std::size_t bytes) {
+    if (cursor == nullptr || static_cast<std::size_t>(limit - cursor) < bytes) {
+        addChunk(bytes);
+    }
+}
+
+void Arena::release() {
+    while (last != nullptr) {
+        Chunk* previous = last->previous;
+        std::free(last);
+        last = previous;
+    }
+    cursor = limit = nullptr;
+    nextChunkBytes = firstChunkBytes;
+    chunkBytes = allocatedBytes = chunks = 0;
+}
+
+Arena& ArenaSet::add() {
+    arenas.push_back(std::make_unique<Arena>());
+    return *arenas.back();
+}
+
+void ArenaSet::release() {
+    arenas.resize(1);
+    arenas[0]->release();
+}
+
+std::size_t ArenaSet::capacity() const {
+    std::size_t bytes = 0;
+    for (const auto& arena : arenas) {
+        bytes += arena->capacity();
+    }
+    return bytes;
+}
+
+std::size_t ArenaSet::chunkCount() const {
+    std::size_t count = 0;
+    for (const auto& arena : arenas) {
+        count += arena->chunkCount();
+    }
+    return count;
+}
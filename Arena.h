@@ -0,0 +1,100 @@
+// File: Arena.h
+// Summary:
+// This file defines the Arena class, a monotonic memory resource, and the ArenaSet class,
+// the arenas that hold the strings of one dictionary generation. An arena hands out memory
+// by moving a pointer through large chunks and never frees single allocations; all of its
+// memory is returned at once when it is released or destroyed. Loading a dictionary into
+// an arena therefore costs a few chunk allocations instead of one allocation per string,
+// and dropping it costs a few frees.
+//
+// Input:
+// - Arena is a std::pmr::memory_resource, so any std::pmr container or string can allocate
+//   from it; Word takes one through its allocator argument.
+// - reserve sizes the next chunk, for example from the size of the file being loaded.
+//
+// Output:
+// - capacity returns the bytes held in chunks, allocated the bytes handed out, and
+//   chunkCount the number of chunks (the number of real heap allocations made).
+// - ArenaSet owns one main arena plus any number of extra ones for loader threads, since
+//   an arena must only be used by one thread at a time.
+//
+// Comments:
+// - Chunks start at firstChunkBytes and double up to maximumChunkBytes; a request larger
+//   than that gets a chunk of its own.
+// - Memory given back through deallocate is not reused. Strings that are assigned or grown
+//   in place leave their old buffer behind, so arenas suit data that is written once.
+// - A string allocated from an arena keeps a pointer to it, so the arena must outlive it.
+//   ArenaSet is built for members of a class that also holds the strings: copying it gives
+//   an empty set (copied std::pmr strings use the default heap resource), and moving it
+//   swaps the sets, so the moved-from object keeps the arenas its old strings live in
+//   until it is destroyed. Declare the ArenaSet before the strings, so the strings are
+//   destroyed first.
+//
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+class Arena : public std::pmr::memory_resource {
+public:
+    static constexpr std::size_t firstChunkBytes = 64 * 1024;
+    static constexpr std::size_t maximumChunkBytes = 4 * 1024 * 1024;
+
+    Arena() = default;
+    ~Arena() override { release(); }
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void reserve(std::size_t bytes); // Makes sure the next bytes of allocations fit in the current chunk.
+    void release(); // Frees every chunk; nothing allocated from the arena may be used afterwards.
+
+    std::size_t capacity() const { return chunkBytes; }
+    std::size_t allocated() const { return allocatedBytes; }
+    std::size_t chunkCount() const { return chunks; }
+
+private:
+    struct Chunk { // Header at the start of every chunk
+        Chunk* previous;
+        std::size_t size;
+    };
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+    void do_deallocate(void*, std::size_t, std::size_t) override {} // Memory only comes back with release
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    void addChunk(std::size_t minimumBytes);
+
+    Chunk* last = nullptr;
+    char* cursor = nullptr;
+    char* limit = nullptr;
+    std::size_t nextChunkBytes = firstChunkBytes;
+    std::size_t chunkBytes = 0;
+    std::size_t allocatedBytes = 0;
+    std::size_t chunks = 0;
+};
+
+class ArenaSet {
+public:
+    ArenaSet() : arenas(1) { arenas[0] = std::make_unique<Arena>(); }
+    ArenaSet(const ArenaSet&) : ArenaSet() {}
+    ArenaSet& operator=(const ArenaSet&) { return *this; } // Keeps its own arenas, which its strings may still use
+    ArenaSet(ArenaSet&& other) : ArenaSet() { arenas.swap(other.arenas); }
+    ArenaSet& operator=(ArenaSet&& other) {
+        arenas.swap(other.arenas);
+        return *this;
+    }
+
+    Arena& main() { return *arenas[0]; }
+    Arena& add(); // Returns a new arena owned by the set, for one more thread.
+    void release(); // Frees every arena's memory and drops the extra arenas.
+
+    std::size_t capacity() const;
+    std::size_t chunkCount() const;
+
+private:
+    std::vector<std::unique_ptr<Arena>> arenas;
+};
+
+#endif // ARENA_H
@@ -0,0 +1,168 @@
+// File: AtomicFile.cpp
+// Summary:
+// This file implements the AtomicFile class: the temporary file, the sync and rename that
+// replace the target, and the descriptor helpers for each platform.
+//
+// Input:
+// - A target file name and the bytes to write.
+//
+// Output:
+// - The target replaced by the bytes written, or left untouched on failure.
+//
+#include "AtomicFile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+namespace {
+
+void copyPermissions(const std::string&, int) {}
+
+} // namespace
+
+int AtomicFile::openForWriting(const std::string& path, bool append) {
+    const int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (append ? _O_APPEND : _O_TRUNC);
+    return _open(path.c_str(), flags, _S_IREAD | _S_IWRITE);
+}
+
+bool AtomicFile::writeAll(int fd, std::string_view bytes) {
+    while (!bytes.empty()) {
+        const unsigned chunk = static_cast<unsigned>(std::min<std::size_t>(bytes.size(), 1u << 30));
+        const int written = _write(fd, bytes.data(), chunk);
+        if (written <= 0) {
+            return false;
+        }
+        bytes.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+}
+
+bool AtomicFile::syncFile(int fd) { return _commit(fd) == 0; }
+bool AtomicFile::closeFile(int fd) { return _close(fd) == 0; }
+void AtomicFile::syncDirectory(const std::string&) {} // NTFS commits directory entries with the rename
+
+bool AtomicFile::replaceFile(const std::string& from, const std::string& to) {
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+#else
+
+namespace {
+
+void copyPermissions(const std::string& from, int fd) {
+    struct stat info;
+    if (stat(from.c_str(), &info) == 0) {
+        fchmod(fd, info.st_mode & 07777);
+    }
+}
+
+} // namespace
+
+int AtomicFile::openForWriting(const std::string& path, bool append) {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | (append ? O_APPEND : O_TRUNC), 0644);
+}
+
+bool AtomicFile::writeAll(int fd, std::string_view bytes) {
+    while (!bytes.empty()) {
+        const ssize_t written = ::write(fd, bytes.data(), bytes.size());
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+}
+
+bool AtomicFile::syncFile(int fd) {
+#if defined(__linux__)
+    return fdatasync(fd) == 0; // The size is data here; only timestamps are skipped
+#else
+    return fsync(fd) == 0;
+#endif
+}
+
+bool AtomicFile::closeFile(int fd) { return ::close(fd) == 0; }
+
+void AtomicFile::syncDirectory(const std::string& path) {
+    const std::size_t slash = path.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) {
+        fsync(fd);
+        ::close(fd);
+    }
+}
+
+bool AtomicFile::replaceFile(const std::string& from, const std::string& to) {
+    return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+#endif
+
+AtomicFile::AtomicFile(std::string target, const char* temporarySuffix)
+    : target(std::move(target)) {
+    temporary = this->target + temporarySuffix;
+}
+
+AtomicFile::~AtomicFile() {
+    if (fd >= 0) { // Opened but never committed
+        closeFile(fd);
+        std::remove(temporary.c_str());
+    }
+}
+
+bool AtomicFile::open() {
+    fd = openForWriting(temporary, false);
+    if (fd < 0) {
+        return false;
+    }
+    copyPermissions(target, fd);
+    return true;
+}
+
+bool AtomicFile::write(std::string_view bytes) {
+    if (fd < 0 || failed) {
+        return false;
+    }
+    failed = !writeAll(fd, bytes);
+    return !failed;
+}
+
+// - commit(): The data is synced before the rename, so the name can never point at a file
+//   whose contents are still only in the page cache; the directory sync then makes the
+//   rename itself durable.
+bool AtomicFile::commit() {
+    if (fd < 0 || failed) {
+        return false;
+    }
+    bool ok = syncFile(fd);
+    ok = closeFile(fd) && ok;
+    fd = -1;
+    if (!ok || !replaceFile(temporary, target)) {
+        failed = true;
+        std::remove(temporary.c_str());
+        return false;
+    }
+    syncDirectory(target);
+    return true;
+}
@@ -0,0 +1,56 @@
+// File: AtomicFile.h
+// Summary:
+// This file defines the AtomicFile class, which replaces a file so that it survives a crash
+// at any point: the new contents go to a temporary file beside the target, which is synced
+// and then renamed over the target, and the rename itself is synced through the directory.
+// Readers and a restarted program find either the old file or the new one, never a mix.
+// It also holds the descriptor level helpers (whole writes, fsync, directory sync) that the
+// journal uses for its appends.
+//
+// Input:
+// - The target file name, then the bytes of the new contents in any number of writes.
+//
+// Output:
+// - commit returns true once the target holds exactly the bytes written. On any failure,
+//   or if the AtomicFile is destroyed without a commit, the temporary file is removed and
+//   the target is left as it was.
+//
+// Comments:
+// - Writes go straight to the descriptor, so callers should hand over large buffers; each
+//   write is one system call (or a few, for very large buffers).
+// - The temporary file takes the permissions of the file it replaces.
+//
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+class AtomicFile {
+public:
+    explicit AtomicFile(std::string target, const char* temporarySuffix = ".tmp");
+    ~AtomicFile(); // The destructor discards the temporary file unless commit succeeded.
+    AtomicFile(const AtomicFile&) = delete;
+    AtomicFile& operator=(const AtomicFile&) = delete;
+
+    bool open(); // Creates the temporary file.
+    bool write(std::string_view bytes); // Appends bytes to the temporary file.
+    bool commit(); // Syncs the temporary file and renames it over the target.
+    const std::string& temporaryPath() const { return temporary; }
+
+    static int openForWriting(const std::string& path, bool append); // Returns a descriptor, or -1.
+    static bool writeAll(int fd, std::string_view bytes); // Retries short and interrupted writes.
+    static bool syncFile(int fd);
+    static bool closeFile(int fd);
+    static void syncDirectory(const std::string& path); // Makes a create, rename or unlink in path's directory durable.
+    static bool replaceFile(const std::string& from, const std::string& to);
+
+private:
+    std::string target;
+    std::string temporary;
+    int fd = -1;
+    bool failed = false;
+};
+
+#endif // ATOMICFILE_H
@@ -0,0 +1,224 @@
+// File: CaseFold.cpp
+// Summary:
+// This file implements the CaseFold kernels. A byte is uppercase when min(c - 'A', 25) equals
+// c - 'A' (an unsigned range test SSE2 can do), and folding adds 0x20 to exactly those bytes.
+// A block is reversed with one byte shuffle under AVX2, and with word shuffles plus a byte
+// swap inside each 16 bit lane under plain SSE2, which has no byte shuffle. Most names are
+// shorter than a vector block, so the same tests are also done on 8 bytes in a 64 bit word.
+//
+// Input:
+// - Buffers of any length; the block loops handle whole blocks and a scalar loop the rest.
+//
+// Output:
+// - The same results as the scalar versions on every target.
+//
+#include "CaseFold.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Eight bytes at a time in a plain 64 bit register, for names shorter than a vector block and
+// for targets without SIMD. Only the low seven bits of each byte take part in the additions,
+// so no carry crosses into the next byte, and bytes with the high bit set are never folded.
+std::uint64_t load8(const char* bytes) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+std::uint64_t lower8(std::uint64_t word) {
+    const std::uint64_t ones = 0x0101010101010101ull;
+    const std::uint64_t highBits = ones * 0x80;
+    const std::uint64_t low = word & ~highBits;
+    const std::uint64_t atLeastA = low + ones * (0x80 - 'A');     // High bit set where the byte is >= 'A'
+    const std::uint64_t aboveZ = low + ones * (0x80 - 'Z' - 1);   // High bit set where the byte is > 'Z'
+    const std::uint64_t upper = (atLeastA ^ aboveZ) & ~word & highBits;
+    return word | (upper >> 2); // 0x80 >> 2 is the 0x20 case bit
+}
+
+std::uint64_t reverse8(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(word);
+#else
+    word = ((word & 0x00FF00FF00FF00FFull) << 8) | ((word >> 8) & 0x00FF00FF00FF00FFull);
+    word = ((word & 0x0000FFFF0000FFFFull) << 16) | ((word >> 16) & 0x0000FFFF0000FFFFull);
+    return (word << 32) | (word >> 32);
+#endif
+}
+
+#if defined(__SSE2__)
+__m128i lower16(__m128i bytes) {
+    const __m128i fromA = _mm_sub_epi8(bytes, _mm_set1_epi8('A'));
+    const __m128i upper = _mm_cmpeq_epi8(_mm_min_epu8(fromA, _mm_set1_epi8('Z' - 'A')), fromA);
+    return _mm_add_epi8(bytes, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+__m128i reverse16(__m128i bytes) {
+    __m128i reversed = _mm_shuffle_epi32(bytes, _MM_SHUFFLE(0, 1, 2, 3)); // Reverse the four 32 bit words
+    reversed = _mm_shufflelo_epi16(reversed, _MM_SHUFFLE(2, 3, 0, 1));    // Swap the 16 bit halves of each word
+    reversed = _mm_shufflehi_epi16(reversed, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(_mm_slli_epi16(reversed, 8), _mm_srli_epi16(reversed, 8)); // Swap the bytes of each half
+}
+#endif
+
+#if defined(__AVX2__)
+__m256i lower32(__m256i bytes) {
+    const __m256i fromA = _mm256_sub_epi8(bytes, _mm256_set1_epi8('A'));
+    const __m256i upper = _mm256_cmpeq_epi8(_mm256_min_epu8(fromA, _mm256_set1_epi8('Z' - 'A')), fromA);
+    return _mm256_add_epi8(bytes, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+__m256i reverse32(__m256i bytes) {
+    const __m256i withinLanes = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                                 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    return _mm256_permute2x128_si256(_mm256_shuffle_epi8(bytes, withinLanes), bytes, 0x01); // Then swap the two lanes
+}
+#endif
+
+} // namespace
+
+void CaseFold::toLowerScalar(const char* source, std::size_t length, char* destination) {
+    for (std::size_t i = 0; i < length; ++i) {
+        destination[i] = lower(source[i]);
+    }
+}
+
+bool CaseFold::equalsIgnoreCaseScalar(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (lower(a[i]) != lower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CaseFold::isPalindromeScalar(std::string_view word) {
+    if (word.empty()) {
+        return true;
+    }
+    std::size_t i = 0, j = word.size() - 1;
+    while (i < j) {
+        if (lower(word[i]) != lower(word[j])) {
+            return false;
+        }
+        i++;
+        j--;
+    }
+    return true;
+}
+
+void CaseFold::toLower(const char* source, std::size_t length, char* destination) {
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= length; i += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), lower32(bytes));
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= length; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), lower16(bytes));
+    }
+#endif
+    for (; i + 8 <= length; i += 8) {
+        const std::uint64_t word = lower8(load8(source + i));
+        std::memcpy(destination + i, &word, sizeof(word));
+    }
+    toLowerScalar(source + i, length - i, destination + i);
+}
+
+bool CaseFold::equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 32 <= a.size(); i += 32) {
+        const __m256i left = lower32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a.data() + i)));
+        const __m256i right = lower32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b.data() + i)));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(left, right)) != -1) {
+            return false;
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    for (; i + 16 <= a.size(); i += 16) {
+        const __m128i left = lower16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + i)));
+        const __m128i right = lower16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + i)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(left, right)) != 0xFFFF) {
+            return false;
+        }
+    }
+#endif
+    for (; i + 8 <= a.size(); i += 8) {
+        if (lower8(load8(a.data() + i)) != lower8(load8(b.data() + i))) {
+            return false;
+        }
+    }
+    for (; i < a.size(); ++i) {
+        if (lower(a[i]) != lower(b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int CaseFold::compareIgnoreCase(std::string_view a, std::string_view b) {
+    const std::size_t shared = a.size() < b.size() ? a.size() : b.size();
+    std::size_t i = 0;
+    while (i + 8 <= shared && lower8(load8(a.data() + i)) == lower8(load8(b.data() + i))) {
+        i += 8; // Skip the equal blocks; the first difference is then found a byte at a time
+    }
+    for (; i < shared; ++i) {
+        const auto left = static_cast<unsigned char>(lower(a[i]));
+        const auto right = static_cast<unsigned char>(lower(b[i]));
+        if (left != right) {
+            return left < right ? -1 : 1;
+        }
+    }
+    if (a.size() == b.size()) {
+        return 0;
+    }
+    return a.size() < b.size() ? -1 : 1;
+}
+
+bool CaseFold::isPalindrome(std::string_view word) {
+    if (word.size() >= 2 && lower(word.front()) != lower(word.back())) {
+        return false; // Most names fail on the outer pair, before any block is worth loading
+    }
+    std::size_t front = 0;
+    std::size_t back = word.size(); // One past the last byte not yet compared
+#if defined(__AVX2__)
+    for (; front + 64 <= back; front += 32, back -= 32) {
+        const __m256i head = lower32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(word.data() + front)));
+        const __m256i tail = lower32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(word.data() + back - 32)));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi8(head, reverse32(tail))) != -1) {
+            return false;
+        }
+    }
+#endif
+#if defined(__SSE2__)
+    for (; front + 32 <= back; front += 16, back -= 16) {
+        const __m128i head = lower16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(word.data() + front)));
+        const __m128i tail = lower16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(word.data() + back - 16)));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(head, reverse16(tail))) != 0xFFFF) {
+            return false;
+        }
+    }
+#endif
+    for (; front + 16 <= back; front += 8, back -= 8) {
+        if (lower8(load8(word.data() + front)) != reverse8(lower8(load8(word.data() + back - 8)))) {
+            return false;
+        }
+    }
+    return isPalindromeScalar(word.substr(front, back - front)); // The unmatched middle is a palindrome on its own
+}
@@ -0,0 +1,65 @@
+// File: ClozeIndex.cpp
+// Summary:
+// This file implements the ClozeIndex class: finding the hidden word of a definition,
+// adding the question of a new word, and picking a question.
+//
+// Input:
+// - Definitions as string views, and random numbers.
+//
+// Output:
+// - Questions: entry positions with the offset and length of their hidden word.
+//
+#include "ClozeIndex.h"
+#include "Tokenizer.h"
+
+// - locate(std::string_view definition, Question& question): Reads the definition's words,
+//   remembering where the hidden one is.
+bool ClozeIndex::locate(std::string_view definition, Question& question) {
+    std::size_t words = 0;
+    bool found = false;
+    Tokenizer::forEach(definition, [&](std::string_view word) {
+        if (words == hiddenWord) {
+            question.offset = static_cast<std::uint32_t>(word.data() - definition.data());
+            question.length = static_cast<std::uint32_t>(word.size());
+        }
+        ++words;
+        found = words > hiddenWord + 1; // A question needs at least one word after the hidden one
+    });
+    return found;
+}
+
+void ClozeIndex::clear() {
+    questions.clear();
+    external = nullptr;
+    externalSize = 0;
+    externalOwner.reset();
+}
+
+void ClozeIndex::detach() {
+    if (external == nullptr) {
+        return;
+    }
+    questions.assign(external, external + externalSize);
+    external = nullptr;
+    externalSize = 0;
+    externalOwner.reset();
+}
+
+void ClozeIndex::insert(std::uint32_t entry, std::string_view definition) {
+    Question question;
+    if (!locate(definition, question)) {
+        return;
+    }
+    detach();
+    question.entry = entry;
+    questions.push_back(question); // Newest position, so the pool stays in entry order
+}
+
+bool ClozeIndex::pick(std::uint64_t random, Question& question) const {
+    const std::size_t count = size();
+    if (count == 0) {
+        return false;
+    }
+    question = data()[random % count]; // The modulo bias is below 2^-32 for any pool that fits in 32-bit positions
+    return true;
+}
@@ -0,0 +1,100 @@
+// File: ClozeIndex.h
+// Summary:
+// This file defines the ClozeIndex class, the pool of questions for the Guess the Fourth
+// Word game. Every entry whose definition has more than four words can be a question, with
+// its fourth word hidden. The index lists those entries once, at load time, together with
+// where the hidden word sits in the definition, so a question is picked with one random
+// number and never needs the definition to be split again.
+//
+// Input:
+// - build and insert take entry positions together with their definitions.
+// - pick takes a random number; any generator may supply it.
+//
+// Output:
+// - pick returns a Question: the entry, and the offset and length of the hidden word in the
+//   entry's definition. It returns false when no definition is long enough, including for
+//   an empty dictionary.
+// - The whole index is one array of Questions in entry order, which is what gets stored in
+//   snapshots. Like the other indexes it can be attached to a mapped snapshot and is copied
+//   into owned storage on the first insert.
+//
+// Comments:
+// - A word is what Tokenizer reads as one (a run of characters that are not whitespace),
+//   as it was when the game split the definition with std::istringstream.
+// - pick is const and uses nothing but its argument, so any number of threads can draw
+//   questions at once, each with its own generator.
+//
+#ifndef CLOZEINDEX_H
+#define CLOZEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class ClozeIndex {
+public:
+    static constexpr std::size_t hiddenWord = 3; // Zero based, so the fourth word
+
+    struct Question {
+        std::uint32_t entry;
+        std::uint32_t offset; // Of the hidden word in the definition
+        std::uint32_t length;
+    };
+
+    static bool locate(std::string_view definition, Question& question); // Fills offset and length if the definition is long enough.
+
+    void clear(); // The clear function removes every question.
+    template <typename DefinitionSize>
+    bool attach(const Question* questions, std::size_t count, std::size_t entryCount, DefinitionSize definitionSize, std::shared_ptr<const void> owner); // Uses a serialized pool without copying it; false unless the entries increase, stay below entryCount and every hidden word lies inside its definition.
+    void detach(); // The detach function copies an attached pool into owned storage.
+
+    const Question* data() const { return external ? external : questions.data(); }
+    std::size_t size() const { return external ? externalSize : questions.size(); }
+
+    template <typename DefinitionAt>
+    void build(std::size_t entryCount, DefinitionAt definitionAt); // The build function indexes entries 0 to entryCount - 1.
+
+    void insert(std::uint32_t entry, std::string_view definition); // Adds entry if its definition qualifies, entry must be the newest position.
+    bool pick(std::uint64_t random, Question& question) const; // The pick function chooses a question uniformly from a 64-bit random number.
+
+private:
+    std::vector<Question> questions;
+    const Question* external = nullptr;
+    std::size_t externalSize = 0;
+    std::shared_ptr<const void> externalOwner;
+};
+
+template <typename DefinitionAt>
+void ClozeIndex::build(std::size_t entryCount, DefinitionAt definitionAt) {
+    clear();
+    Question question;
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        if (locate(definitionAt(i), question)) {
+            question.entry = static_cast<std::uint32_t>(i);
+            questions.push_back(question);
+        }
+    }
+}
+
+template <typename DefinitionSize>
+bool ClozeIndex::attach(const Question* serialized, std::size_t count, std::size_t entryCount, DefinitionSize definitionSize, std::shared_ptr<const void> owner) {
+    for (std::size_t i = 0; i < count; ++i) {
+        const Question& question = serialized[i];
+        if (question.entry >= entryCount || (i > 0 && question.entry <= serialized[i - 1].entry)
+            || std::uint64_t(question.offset) + question.length > definitionSize(question.entry)) {
+            return false;
+        }
+    }
+
+    questions.clear();
+    questions.shrink_to_fit();
+    external = serialized;
+    externalSize = count;
+    externalOwner = std::move(owner);
+    return true;
+}
+
+#endif // CLOZEINDEX_H
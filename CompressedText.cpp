@@ -0,0 +1,203 @@
+// File: CompressedText.cpp
+// Summary:
+// This file implements the CompressedText class: cutting text into blocks at entry ends,
+// compressing them, and reading them back through the per-thread pin and the LRU cache.
+//
+// Input:
+// - Entry text with its entry ends, and offsets into the uncompressed text.
+//
+// Output:
+// - Views of decompressed text.
+//
+#include "CompressedText.h"
+#include "LzCodec.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+
+namespace {
+
+constexpr std::size_t samplePieces = 256; // Spread over the whole text so the dictionary sees every part of it
+constexpr std::size_t samplePieceBytes = 4096;
+
+struct Pin { // The block a thread read last
+    std::uint64_t identity = 0;
+    std::size_t index = 0;
+    std::shared_ptr<const std::string> text;
+};
+
+thread_local Pin pin;
+
+} // namespace
+
+std::uint64_t CompressedText::nextIdentity() {
+    static std::atomic<std::uint64_t> counter{0};
+    return ++counter;
+}
+
+CompressedText::CompressedText()
+    : packedStarts{0}, blockStarts{0}, identity(nextIdentity()), cache(std::make_unique<Cache>()) {}
+
+CompressedText::CompressedText(const CompressedText& other)
+    : packed(other.packed), packedStarts(other.packedStarts), blockStarts(other.blockStarts),
+      dictionary(other.dictionary), identity(nextIdentity()), cache(std::make_unique<Cache>()) {}
+
+CompressedText& CompressedText::operator=(const CompressedText& other) {
+    if (this != &other) {
+        packed = other.packed;
+        packedStarts = other.packedStarts;
+        blockStarts = other.blockStarts;
+        dictionary = other.dictionary;
+        identity = nextIdentity();
+        cache = std::make_unique<Cache>();
+    }
+    return *this;
+}
+
+CompressedText::CompressedText(CompressedText&& other)
+    : packed(std::move(other.packed)), packedStarts(std::move(other.packedStarts)), blockStarts(std::move(other.blockStarts)),
+      dictionary(std::move(other.dictionary)), identity(other.identity), cache(std::move(other.cache)) {
+    other.clear();
+}
+
+CompressedText& CompressedText::operator=(CompressedText&& other) {
+    if (this != &other) {
+        packed = std::move(other.packed);
+        packedStarts = std::move(other.packedStarts);
+        blockStarts = std::move(other.blockStarts);
+        dictionary = std::move(other.dictionary);
+        identity = other.identity;
+        cache = std::move(other.cache);
+        other.clear();
+    }
+    return *this;
+}
+
+void CompressedText::clear() {
+    packed.clear();
+    packed.shrink_to_fit();
+    packedStarts.assign(1, 0);
+    blockStarts.assign(1, 0);
+    dictionary.clear();
+    identity = nextIdentity();
+    cache = std::make_unique<Cache>();
+}
+
+// - append(text, entryEnds, entryCount): Closes a block at the first entry end that reaches
+//   blockBytes, so an entry longer than a block gets a block of its own.
+void CompressedText::append(std::string_view text, const std::uint64_t* entryEnds, std::size_t entryCount) {
+    std::vector<std::uint64_t> cuts{0}; // Block boundaries within text
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        if (entryEnds[i] - cuts.back() >= blockBytes || i + 1 == entryCount) {
+            if (entryEnds[i] > cuts.back()) {
+                cuts.push_back(entryEnds[i]);
+            }
+        }
+    }
+    if (cuts.size() < 2) {
+        return; // Nothing but empty entries
+    }
+
+    if (blockCount() == 0 && text.size() >= blockBytes) {
+        std::string sample;
+        const std::size_t step = std::max(samplePieceBytes, text.size() / samplePieces);
+        for (std::size_t start = 0; start < text.size(); start += step) {
+            sample.append(text.substr(start, samplePieceBytes));
+        }
+        dictionary = LzCodec::train(sample, dictionaryBytes);
+    }
+
+    // Each range of blocks is compressed into one buffer, remembering where its blocks end
+    const std::size_t count = cuts.size() - 1;
+    std::vector<std::string> ranges(count);
+    std::vector<std::size_t> blockEnds(count);
+    std::vector<std::size_t> rangeOf(count);
+    ThreadPool::shared().parallelFor(count, [&](std::size_t begin, std::size_t end) {
+        std::string& out = ranges[begin];
+        out.reserve(static_cast<std::size_t>(cuts[end] - cuts[begin]));
+        for (std::size_t b = begin; b < end; ++b) {
+            LzCodec::compress(text.substr(cuts[b], cuts[b + 1] - cuts[b]), dictionary, out);
+            blockEnds[b] = out.size();
+            rangeOf[b] = begin;
+        }
+    });
+
+    std::size_t total = packed.size();
+    for (const std::string& range : ranges) {
+        total += range.size();
+    }
+    packed.reserve(total);
+    const std::uint64_t base = size();
+    for (std::size_t b = 0; b < count; ++b) {
+        const std::string& range = ranges[rangeOf[b]];
+        if (rangeOf[b] == b) {
+            packed.insert(packed.end(), range.begin(), range.end());
+        }
+        packedStarts.push_back(packed.size() - range.size() + blockEnds[b]);
+        blockStarts.push_back(base + cuts[b + 1]);
+    }
+}
+
+CompressedText::Block CompressedText::block(std::size_t index) const {
+    {
+        std::lock_guard<std::mutex> lock(cache->mutex);
+        const auto found = cache->byBlock.find(index);
+        if (found != cache->byBlock.end()) {
+            cache->recent.splice(cache->recent.begin(), cache->recent, found->second);
+            return found->second->second;
+        }
+    }
+
+    auto text = std::make_shared<std::string>(static_cast<std::size_t>(blockStarts[index + 1] - blockStarts[index]), '\0');
+    if (!LzCodec::decompress(packed.data() + packedStarts[index], static_cast<std::size_t>(packedStarts[index + 1] - packedStarts[index]),
+                             dictionary, text->data(), text->size())) {
+        std::cerr << "Corrupt compressed definition block " << index << "\n";
+        text->assign(text->size(), '?'); // Keeps the sizes every caller relies on
+    }
+
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    const auto found = cache->byBlock.find(index);
+    if (found != cache->byBlock.end()) { // Another thread decoded it meanwhile
+        return found->second->second;
+    }
+    cache->recent.emplace_front(index, text);
+    cache->byBlock.emplace(index, cache->recent.begin());
+    if (cache->recent.size() > cacheBlocks) {
+        cache->byBlock.erase(cache->recent.back().first);
+        cache->recent.pop_back();
+    }
+    return text;
+}
+
+std::string_view CompressedText::view(std::uint64_t offset, std::size_t length) const {
+    const std::size_t index = static_cast<std::size_t>(std::upper_bound(blockStarts.begin(), blockStarts.end(), offset) - blockStarts.begin()) - 1;
+    if (pin.identity != identity || pin.index != index || !pin.text) {
+        pin.text = block(index);
+        pin.identity = identity;
+        pin.index = index;
+    }
+    return std::string_view(pin.text->data() + (offset - blockStarts[index]), length);
+}
+
+bool CompressedText::unpack(std::vector<char>& out) const {
+    const std::size_t start = out.size();
+    out.resize(start + static_cast<std::size_t>(size()));
+    for (std::size_t b = 0; b < blockCount(); ++b) {
+        if (!LzCodec::decompress(packed.data() + packedStarts[b], static_cast<std::size_t>(packedStarts[b + 1] - packedStarts[b]),
+                                 dictionary, out.data() + start + blockStarts[b], static_cast<std::size_t>(blockStarts[b + 1] - blockStarts[b]))) {
+            out.resize(start);
+            return false;
+        }
+    }
+    return true;
+}
+
+std::size_t CompressedText::memoryUsage() const {
+    std::size_t bytes = packed.capacity() + (packedStarts.capacity() + blockStarts.capacity()) * sizeof(std::uint64_t) + dictionary.capacity();
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    for (const auto& cached : cache->recent) {
+        bytes += cached.second->capacity();
+    }
+    return bytes;
+}
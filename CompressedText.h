@@ -0,0 +1,87 @@
+// File: CompressedText.h
+// Summary:
+// This file defines the CompressedText class, a read-mostly run of text (the definitions of
+// a WordStore) kept as independently compressed blocks. Each block holds whole entries, so
+// any entry is read by decompressing one block. Recently used blocks are kept decompressed
+// in a small LRU cache shared by all threads.
+//
+// Input:
+// - append takes the text of a run of entries and where each entry ends, and compresses it
+//   block by block after the text already held.
+// - view takes an offset and length within the uncompressed text.
+//
+// Output:
+// - view returns the bytes as a string view into a decompressed block. The view stays
+//   valid until the same thread calls view again for another block (of any CompressedText),
+//   because each thread pins the block it read last; the cache may drop it meanwhile.
+// - unpack writes the whole uncompressed text, memoryUsage reports the compressed bytes,
+//   the block tables and what the cache currently holds.
+//
+// Comments:
+// - Blocks hold about blockBytes of text. The first append trains a shared dictionary of
+//   dictionaryBytes on a sample of the text (see LzCodec::train) that primes every block,
+//   which gives small blocks most of the ratio of large ones. Blocks are compressed in
+//   parallel on the thread pool.
+// - A read of the block a thread read last takes no lock. Any other read takes the cache
+//   lock for a lookup; a miss decompresses outside the lock (about 30 microseconds for a
+//   block), then evicts the least recently used block if cacheBlocks are held.
+// - Copies share nothing: a copy gets its own blocks and an empty cache.
+//
+#ifndef COMPRESSEDTEXT_H
+#define COMPRESSEDTEXT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class CompressedText {
+public:
+    static constexpr std::size_t blockBytes = 4 * 1024;
+    static constexpr std::size_t dictionaryBytes = 32 * 1024;
+    static constexpr std::size_t cacheBlocks = 256;
+
+    CompressedText();
+    CompressedText(const CompressedText& other);
+    CompressedText& operator=(const CompressedText& other);
+    CompressedText(CompressedText&& other);
+    CompressedText& operator=(CompressedText&& other);
+
+    void clear(); // The clear function removes all text and empties the cache.
+    std::uint64_t size() const { return blockStarts.back(); } // Bytes of uncompressed text held
+    std::size_t blockCount() const { return blockStarts.size() - 1; }
+
+    void append(std::string_view text, const std::uint64_t* entryEnds, std::size_t entryCount); // entryEnds are offsets into text, ascending.
+    std::string_view view(std::uint64_t offset, std::size_t length) const; // The range must lie within one entry.
+    bool unpack(std::vector<char>& out) const; // Appends the whole uncompressed text to out.
+
+    std::size_t compressedSize() const { return packed.size(); }
+    std::size_t memoryUsage() const;
+
+private:
+    using Block = std::shared_ptr<const std::string>;
+
+    struct Cache {
+        std::mutex mutex;
+        std::list<std::pair<std::size_t, Block>> recent; // Most recently used first
+        std::unordered_map<std::size_t, std::list<std::pair<std::size_t, Block>>::iterator> byBlock;
+    };
+
+    Block block(std::size_t index) const; // Decompressed block, from the cache or freshly decoded
+    static std::uint64_t nextIdentity();
+
+    std::vector<char> packed;                 // Compressed blocks back to back
+    std::vector<std::uint64_t> packedStarts;  // blockCount() + 1 offsets into packed
+    std::vector<std::uint64_t> blockStarts;   // blockCount() + 1 offsets into the uncompressed text
+    std::string dictionary;                   // Shared by every block
+    std::uint64_t identity;                   // Distinguishes this text in the per-thread pins, changes with the blocks
+    mutable std::unique_ptr<Cache> cache;
+};
+
+#endif // COMPRESSEDTEXT_H
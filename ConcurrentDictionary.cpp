@@ -0,0 +1,126 @@
+// File: ConcurrentDictionary.cpp
+// Summary:
+// This file implements the ConcurrentDictionary class: claiming reader slots, pinning the
+// current version, and the left-right write protocol with its grace period.
+//
+// Input:
+// - A dictionary to serve, and words or changes from writer threads.
+//
+// Output:
+// - Readers that always see a complete version, and writes that become visible all at once.
+//
+// Comments:
+// - A reader stores the version it is about to use in its slot and then checks that it is
+//   still the current one. A writer stores the new current version and then scans every
+//   slot. With sequentially consistent atomics, either the writer sees the reader's slot
+//   or the reader sees the new version and tries again, so no reader can be left using a
+//   copy the writer goes on to change.
+//
+#include "ConcurrentDictionary.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+ConcurrentDictionary::ConcurrentDictionary(const ImprovedDictionary& dictionary)
+        : slotCount(std::max<std::size_t>(64, std::size_t(4) * std::thread::hardware_concurrency())),
+          slots(new ReaderSlot[slotCount]) {
+    copies[0] = std::make_unique<ImprovedDictionary>(dictionary);
+    copies[1] = std::make_unique<ImprovedDictionary>(dictionary);
+    current.store(copies[0].get());
+}
+
+ConcurrentDictionary::Reader::~Reader() {
+    if (slot != nullptr) {
+        slot->version.store(nullptr);
+        slot->claimed.store(false, std::memory_order_release);
+    }
+}
+
+// - read(): Claims a free slot, starting from one chosen per thread so a thread keeps using
+//   the same cache line, then pins the current version in it.
+ConcurrentDictionary::Reader ConcurrentDictionary::read() const {
+    static thread_local std::size_t preferred = std::hash<std::thread::id>()(std::this_thread::get_id());
+    ReaderSlot* slot = nullptr;
+    for (std::size_t i = preferred % slotCount, tried = 0;; i = (i + 1) % slotCount, ++tried) {
+        ReaderSlot& candidate = slots[i];
+        if (!candidate.claimed.load(std::memory_order_relaxed) && !candidate.claimed.exchange(true, std::memory_order_acquire)) {
+            slot = &candidate;
+            preferred = i;
+            break;
+        }
+        if (tried % slotCount == slotCount - 1) {
+            std::this_thread::yield(); // More readers than slots; one will be released shortly
+        }
+    }
+
+    const ImprovedDictionary* version = current.load();
+    while (true) {
+        slot->version.store(version);
+        const ImprovedDictionary* latest = current.load();
+        if (latest == version) {
+            return Reader(slot, version);
+        }
+        version = latest; // A writer published in between; pin the newer version instead
+    }
+}
+
+void ConcurrentDictionary::waitForReaders(const ImprovedDictionary* version) const {
+    for (std::size_t i = 0; i < slotCount; ++i) {
+        while (slots[i].version.load() == version) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool ConcurrentDictionary::update(const std::function<bool(ImprovedDictionary&)>& change) {
+    std::lock_guard<std::mutex> lock(writer);
+    ImprovedDictionary* visible = current.load() == copies[0].get() ? copies[0].get() : copies[1].get();
+    ImprovedDictionary* standby = visible == copies[0].get() ? copies[1].get() : copies[0].get();
+
+    if (!change(*standby)) { // No reader uses the standby copy since the last grace period
+        return false;
+    }
+    current.store(standby);
+    waitForReaders(visible);
+    change(*visible); // Brings the other copy level again for the next write
+    return true;
+}
+
+bool ConcurrentDictionary::addWord(const Word& word) {
+    return update([&word](ImprovedDictionary& dictionary) { return dictionary.addWord(word); });
+}
+
+// - replace(ImprovedDictionary dictionary): Moves the new dictionary into the standby copy and
+//   publishes it; the other copy is brought level by copying once its readers are gone.
+void ConcurrentDictionary::replace(ImprovedDictionary dictionary) {
+    std::lock_guard<std::mutex> lock(writer);
+    const std::size_t visible = current.load() == copies[0].get() ? 0 : 1;
+    *copies[1 - visible] = std::move(dictionary);
+    current.store(copies[1 - visible].get());
+    waitForReaders(copies[visible].get());
+    *copies[visible] = *copies[1 - visible];
+}
+
+bool ConcurrentDictionary::reload(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(reloading);
+    ImprovedDictionary loaded;
+    {
+        Reader reader = read(); // Keep the settings the served dictionary was loaded with
+        loaded.setStorageMode(reader->getStorageMode());
+        loaded.setLoadThreads(reader->getLoadThreads());
+    }
+    if (!loaded.loadDictionaryFromFile(filename)) {
+        std::cerr << "Reload failed, still serving the previous dictionary: " << filename << "\n";
+        return false;
+    }
+    replace(std::move(loaded));
+    return true;
+}
+
+std::future<bool> ConcurrentDictionary::reloadInBackground(const std::string& filename) {
+    return std::async(std::launch::async, [this, filename]() { return reload(filename); });
+}
+
+bool ConcurrentDictionary::watchFile(const std::string& filename) {
+    return watcher.start(filename, [this, filename]() { reload(filename); });
+}
@@ -0,0 +1,107 @@
+// File: ConcurrentDictionary.h
+// Summary:
+// This file defines the ConcurrentDictionary class, which lets many threads query an
+// ImprovedDictionary while another thread adds words. Readers never take a lock: they pin
+// the current version through their own reader slot and query it as an ordinary const
+// ImprovedDictionary. Writers never change a version that readers can see.
+//
+// Input:
+// - The constructor takes the dictionary to serve, for example one that was just loaded.
+// - addWord takes a word to add; update takes any change to apply to the dictionary.
+// - reload, reloadInBackground and watchFile take a dictionary file (text or snapshot).
+//
+// Output:
+// - read returns a Reader, which gives const access to one version for as long as it lives.
+//   Every query made through one Reader sees the same version.
+// - addWord and update return whether the change was made. It is visible to every read
+//   that starts after they return.
+// - reload builds a complete new dictionary, with all its indexes, beside the one being
+//   served and then swaps it in, so queries never see an empty or half loaded dictionary.
+//   Readers that pinned the old version keep using it until they let go. If the file
+//   cannot be loaded the current version stays. reloadInBackground does the same on its
+//   own thread, and watchFile reloads whenever a text file is rewritten or any dictionary
+//   file is replaced by rename.
+//
+// Comments:
+// - Two copies of the dictionary are kept (left-right RCU). A writer applies its change to
+//   the copy no reader is using, publishes it with one atomic store, waits until no reader
+//   slot still holds the other copy (the grace period) and then applies the same change to
+//   that copy too. A write therefore costs its change twice, not a copy of the dictionary,
+//   at the price of holding the entries and indexes twice. Mapped snapshots share their
+//   mapping between the two copies until the first write.
+// - Writers are serialised by a mutex and wait for readers, so a thread must not write
+//   while it holds a Reader.
+// - A reload replaces the whole dictionary, so words added with addWord since the file was
+//   written are dropped unless the file has them too.
+// - A snapshot is served straight from its mapping, so it must only ever be replaced by
+//   renaming a new file over it (as DictionarySnapshot::Builder::write does). Readers would
+//   fault on a snapshot truncated or rewritten in place before watchFile could reload it.
+//
+#ifndef CONCURRENTDICTIONARY_H
+#define CONCURRENTDICTIONARY_H
+
+#include "FileWatcher.h"
+#include "ImprovedDictionary.h"
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class ConcurrentDictionary {
+private:
+    struct alignas(64) ReaderSlot { // One cache line per slot, so readers on different cores do not share lines
+        std::atomic<bool> claimed{false};
+        std::atomic<const ImprovedDictionary*> version{nullptr};
+    };
+
+public:
+    class Reader {
+    public:
+        Reader(Reader&& other) noexcept : slot(other.slot), dictionary(other.dictionary) { other.slot = nullptr; }
+        Reader& operator=(Reader&&) = delete;
+        Reader(const Reader&) = delete;
+        ~Reader();
+
+        const ImprovedDictionary& operator*() const { return *dictionary; }
+        const ImprovedDictionary* operator->() const { return dictionary; }
+
+    private:
+        friend class ConcurrentDictionary;
+        Reader(ReaderSlot* slot, const ImprovedDictionary* dictionary) : slot(slot), dictionary(dictionary) {}
+
+        ReaderSlot* slot;
+        const ImprovedDictionary* dictionary;
+    };
+
+    ConcurrentDictionary() : ConcurrentDictionary(ImprovedDictionary()) {}
+    explicit ConcurrentDictionary(const ImprovedDictionary& dictionary);
+    ~ConcurrentDictionary() { stopWatching(); }
+    ConcurrentDictionary(const ConcurrentDictionary&) = delete;
+    ConcurrentDictionary& operator=(const ConcurrentDictionary&) = delete;
+
+    Reader read() const; // The read function pins the current version without locking.
+    bool addWord(const Word& word); // The addWord function adds a word that is not in the dictionary yet.
+    bool update(const std::function<bool(ImprovedDictionary&)>& change); // The change must behave the same on both copies and return false only if it changed nothing.
+    void replace(ImprovedDictionary dictionary); // The replace function publishes a whole new dictionary.
+    bool reload(const std::string& filename); // The reload function loads filename on the calling thread and swaps it in.
+    std::future<bool> reloadInBackground(const std::string& filename); // Same as reload on a new thread; this object must outlive the future.
+    bool watchFile(const std::string& filename); // The watchFile function reloads filename whenever it changes, until stopWatching.
+    void stopWatching() { watcher.stop(); }
+    std::size_t readerSlots() const { return slotCount; }
+
+private:
+    void waitForReaders(const ImprovedDictionary* version) const; // Returns once no reader slot holds version.
+
+    std::unique_ptr<ImprovedDictionary> copies[2];
+    std::atomic<const ImprovedDictionary*> current{nullptr};
+    std::size_t slotCount;
+    std::unique_ptr<ReaderSlot[]> slots;
+    std::mutex writer;
+    std::mutex reloading; // One reload builds at a time, so the newest file always wins
+    FileWatcher watcher;
+};
+
+#endif // CONCURRENTDICTIONARY_H
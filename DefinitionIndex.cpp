@@ -0,0 +1,240 @@
+// File: DefinitionIndex.cpp
+// Summary:
+// This file implements the DefinitionIndex class: the term dictionary, varint coding of the
+// posting lists, the AND / OR queries, and moving the columns in and out of snapshots.
+//
+// Input:
+// - Definitions and query terms as string views.
+//
+// Output:
+// - Posting lists are decoded one at a time. An AND query starts from the shortest list and
+//   intersects the others into it, stopping as soon as nothing is left; an OR query merges
+//   every list.
+//
+#include "DefinitionIndex.h"
+#include "CaseFold.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+void DefinitionIndex::clear() {
+    termChars = WordStoreColumn<char>();
+    termOffsets = WordStoreColumn<std::uint64_t>();
+    postingOffsets = WordStoreColumn<std::uint64_t>();
+    postingBytes = WordStoreColumn<std::uint8_t>();
+    termIndex.clear();
+    added.clear();
+    externalOwner.reset();
+
+    termOffsets.values().push_back(0);
+    postingOffsets.values().push_back(0);
+}
+
+std::string_view DefinitionIndex::term(std::size_t id) const {
+    const std::uint64_t begin = termOffsets[id];
+    return std::string_view(termChars.data() + begin, static_cast<std::size_t>(termOffsets[id + 1] - begin));
+}
+
+std::uint32_t DefinitionIndex::findTerm(std::string_view text) const {
+    return termIndex.find(text, [this](std::uint32_t id) { return term(id); });
+}
+
+std::uint32_t DefinitionIndex::addTerm(std::string_view text) {
+    const std::uint32_t existing = findTerm(text);
+    if (existing != WordIndex::npos) {
+        return existing;
+    }
+
+    std::vector<char>& chars = termChars.values();
+    const std::size_t start = chars.size();
+    chars.resize(start + text.size());
+    CaseFold::toLower(text.data(), text.size(), chars.data() + start);
+    termOffsets.values().push_back(chars.size());
+    const auto id = static_cast<std::uint32_t>(termCount() - 1);
+    termIndex.insert(id, term(id), [this](std::uint32_t other) { return term(other); });
+    return id;
+}
+
+void DefinitionIndex::insert(std::uint32_t entry, std::string_view definition) {
+    Tokenizer::forEach(definition, [this, entry](std::string_view token) {
+        const std::string_view normalized = Tokenizer::normalizeTerm(token);
+        if (normalized.empty()) {
+            return;
+        }
+        const std::uint32_t id = addTerm(normalized);
+        if (postingOffsets.size() < termCount() + 1) { // A new term starts with an empty stored list
+            std::vector<std::uint64_t>& offsets = postingOffsets.values();
+            offsets.push_back(offsets.back());
+        }
+        std::vector<std::uint32_t>& entries = added[id];
+        if (entries.empty() || entries.back() != entry) {
+            entries.push_back(entry);
+        }
+    });
+}
+
+void DefinitionIndex::encode(const std::uint32_t* positions, std::size_t count, std::vector<std::uint8_t>& bytes) {
+    std::uint32_t previous = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t gap = positions[i] - previous; // The first gap is the position itself
+        previous = positions[i];
+        while (gap >= 0x80) {
+            bytes.push_back(static_cast<std::uint8_t>(gap | 0x80));
+            gap >>= 7;
+        }
+        bytes.push_back(static_cast<std::uint8_t>(gap));
+    }
+}
+
+void DefinitionIndex::decode(std::uint32_t id, std::vector<std::uint32_t>& positions) const {
+    positions.clear();
+    const std::uint8_t* byte = postingBytes.data() + postingOffsets[id];
+    const std::uint8_t* end = postingBytes.data() + postingOffsets[id + 1];
+    std::uint32_t position = 0;
+    while (byte < end) {
+        std::uint32_t gap = 0;
+        for (unsigned shift = 0; byte < end && shift < 32; shift += 7) {
+            const std::uint8_t b = *byte++;
+            gap |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) {
+                break;
+            }
+        }
+        position += gap;
+        positions.push_back(position);
+    }
+
+    auto newer = added.find(id);
+    if (newer != added.end()) {
+        positions.insert(positions.end(), newer->second.begin(), newer->second.end());
+    }
+}
+
+std::vector<std::uint32_t> DefinitionIndex::find(const std::vector<std::string_view>& terms, TermMatch match) const {
+    std::vector<std::uint32_t> ids;
+    for (const auto query : terms) {
+        const std::string_view normalized = Tokenizer::normalizeTerm(query);
+        if (normalized.empty()) {
+            continue; // Punctuation alone is never indexed, so it does not restrict the query
+        }
+        const std::uint32_t id = findTerm(normalized);
+        if (id != WordIndex::npos) {
+            ids.push_back(id);
+        } else if (match == TermMatch::All) {
+            return {}; // A term that appears nowhere matches nothing
+        }
+    }
+
+    std::vector<std::uint32_t> result, list, merged;
+    if (ids.empty()) {
+        return result;
+    }
+    if (match == TermMatch::All) {
+        std::sort(ids.begin(), ids.end(), [this](std::uint32_t a, std::uint32_t b) { // Shortest encoded list first
+            return postingOffsets[a + 1] - postingOffsets[a] < postingOffsets[b + 1] - postingOffsets[b];
+        });
+        decode(ids[0], result);
+        for (std::size_t i = 1; i < ids.size() && !result.empty(); ++i) {
+            decode(ids[i], list);
+            merged.clear();
+            std::set_intersection(result.begin(), result.end(), list.begin(), list.end(), std::back_inserter(merged));
+            result.swap(merged);
+        }
+    } else {
+        for (std::uint32_t id : ids) {
+            decode(id, list);
+            merged.clear();
+            std::set_union(result.begin(), result.end(), list.begin(), list.end(), std::back_inserter(merged));
+            result.swap(merged);
+        }
+    }
+    return result;
+}
+
+std::size_t DefinitionIndex::memoryUsage() const {
+    std::size_t bytes = termChars.memoryUsage() + termOffsets.memoryUsage() + postingOffsets.memoryUsage()
+                        + postingBytes.memoryUsage() + termIndex.slotCount() * sizeof(WordIndex::Slot);
+    for (const auto& entries : added) {
+        bytes += entries.second.capacity() * sizeof(std::uint32_t);
+    }
+    return bytes;
+}
+
+void DefinitionIndex::addSections(DictionarySnapshot::Builder& builder) const {
+    using Section = DictionarySnapshot::Section;
+    builder.addSection(Section::TermChars, termChars.data(), termChars.size(), termChars.size());
+    builder.addSection(Section::TermOffsets, termOffsets.data(), termOffsets.size() * sizeof(std::uint64_t), termOffsets.size());
+    builder.addSection(Section::TermIndex, termIndex.slotData(), termIndex.slotCount() * sizeof(WordIndex::Slot), termIndex.size());
+
+    if (added.empty()) {
+        builder.addSection(Section::PostingOffsets, postingOffsets.data(), postingOffsets.size() * sizeof(std::uint64_t), postingOffsets.size());
+        builder.addSection(Section::PostingBytes, postingBytes.data(), postingBytes.size(), postingBytes.size());
+        return;
+    }
+
+    // Fold the entries added since the build into freshly encoded lists
+    std::vector<std::uint64_t> offsets(1, 0);
+    std::vector<std::uint8_t> bytes;
+    std::vector<std::uint32_t> positions;
+    for (std::size_t id = 0; id < termCount(); ++id) {
+        decode(static_cast<std::uint32_t>(id), positions);
+        encode(positions.data(), positions.size(), bytes);
+        offsets.push_back(bytes.size());
+    }
+    builder.addSection(Section::PostingOffsets, offsets.data(), offsets.size() * sizeof(std::uint64_t), offsets.size());
+    builder.addSection(Section::PostingBytes, bytes.data(), bytes.size(), bytes.size());
+}
+
+bool DefinitionIndex::attachSections(const DictionarySnapshot& snapshot, std::shared_ptr<const void> owner) {
+    using Section = DictionarySnapshot::Section;
+    DictionarySnapshot::SectionData chars, charStarts, slots, listStarts, lists;
+    if (!snapshot.section(Section::TermChars, chars) || !snapshot.section(Section::TermOffsets, charStarts)
+        || !snapshot.section(Section::TermIndex, slots) || !snapshot.section(Section::PostingOffsets, listStarts)
+        || !snapshot.section(Section::PostingBytes, lists)) {
+        return false;
+    }
+
+    const auto* charOffsetData = static_cast<const std::uint64_t*>(charStarts.data);
+    const auto* listOffsetData = static_cast<const std::uint64_t*>(listStarts.data);
+    if (charStarts.count == 0 || charStarts.count != listStarts.count || charStarts.size != charStarts.count * sizeof(std::uint64_t)
+        || listStarts.size != listStarts.count * sizeof(std::uint64_t) || charOffsetData[charStarts.count - 1] != chars.size
+        || listOffsetData[listStarts.count - 1] != lists.size || slots.count != charStarts.count - 1) {
+        return false;
+    }
+    for (std::size_t i = 0; i + 1 < charStarts.count; ++i) { // Offsets must never step backwards
+        if (charOffsetData[i] > charOffsetData[i + 1] || listOffsetData[i] > listOffsetData[i + 1]) {
+            return false;
+        }
+    }
+    const auto* listData = static_cast<const std::uint8_t*>(lists.data);
+    for (std::size_t i = 0; i + 1 < listStarts.count; ++i) { // Every decoded position must name an entry
+        std::uint64_t position = 0;
+        for (std::uint64_t at = listOffsetData[i]; at < listOffsetData[i + 1];) {
+            std::uint32_t gap = 0;
+            for (unsigned shift = 0; at < listOffsetData[i + 1] && shift < 32; shift += 7) { // Same steps as decode
+                const std::uint8_t b = listData[at++];
+                gap |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+                if ((b & 0x80) == 0) {
+                    break;
+                }
+            }
+            position += gap;
+            if (position >= snapshot.size()) {
+                return false;
+            }
+        }
+    }
+
+    WordIndex mappedIndex; // An index without terms has no slots to attach
+    if (slots.size != 0 && !mappedIndex.attach(static_cast<const WordIndex::Slot*>(slots.data), slots.size / sizeof(WordIndex::Slot), slots.count, owner)) {
+        return false;
+    }
+    clear();
+    termChars.attach(static_cast<const char*>(chars.data), chars.size);
+    termOffsets.attach(charOffsetData, charStarts.count);
+    postingOffsets.attach(listOffsetData, listStarts.count);
+    postingBytes.attach(static_cast<const std::uint8_t*>(lists.data), lists.size);
+    termIndex = std::move(mappedIndex);
+    externalOwner = std::move(owner);
+    return true;
+}
@@ -0,0 +1,132 @@
+// File: DefinitionIndex.h
+// Summary:
+// This file defines the DefinitionIndex class, an inverted index from the words used in
+// definitions to the entries whose definitions contain them. It answers reverse dictionary
+// queries ("which words are defined using X and Y") without scanning every definition.
+//
+// Input:
+// - build and insert take entry positions and a callable returning the definition at a
+//   position. Definitions are split with the Tokenizer and each token is reduced with
+//   Tokenizer::normalizeTerm; terms are matched ignoring case.
+// - find takes the query terms (normalized the same way) and whether all or any must match.
+//
+// Output:
+// - find returns the matching positions in dictionary order.
+// - Each term's posting list is stored as varint encoded gaps between increasing positions,
+//   all lists back to back in one byte array, so a typical posting takes one or two bytes.
+//   Terms live in a character arena with a WordIndex over them. These columns are what get
+//   stored in snapshots, and like WordStore they can be used in place from a mapped snapshot.
+// - Entries added after the index was built are kept in short uncompressed lists per term,
+//   which find merges in and addSections folds into the stored lists.
+//
+#ifndef DEFINITIONINDEX_H
+#define DEFINITIONINDEX_H
+
+#include "DictionarySnapshot.h"
+#include "Tokenizer.h"
+#include "WordIndex.h"
+#include "WordStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+enum class TermMatch {
+    All, // Every term must appear in the definition
+    Any, // At least one term must appear
+};
+
+class DefinitionIndex {
+public:
+    DefinitionIndex() { clear(); }
+
+    void clear(); // The clear function removes every term and posting.
+
+    template <typename DefinitionAt>
+    void build(std::size_t entryCount, DefinitionAt definitionAt); // The build function indexes entries 0 to entryCount - 1.
+
+    void insert(std::uint32_t entry, std::string_view definition); // Indexes the definition of a new entry, entry must be the newest position.
+
+    std::vector<std::uint32_t> find(const std::vector<std::string_view>& terms, TermMatch match) const; // Lists the entries whose definitions contain the terms.
+
+    std::size_t termCount() const { return termOffsets.size() - 1; }
+    std::string_view term(std::size_t id) const;
+    std::size_t memoryUsage() const; // The memoryUsage function returns the bytes allocated for the owned columns.
+
+    void addSections(DictionarySnapshot::Builder& builder) const; // Stores the terms and posting lists as snapshot sections.
+    bool attachSections(const DictionarySnapshot& snapshot, std::shared_ptr<const void> owner); // Uses the sections of a mapped snapshot in place; false if an offset or posting is out of range.
+
+private:
+    std::uint32_t findTerm(std::string_view term) const;
+    std::uint32_t addTerm(std::string_view term); // Returns the id of term, adding it if it is new
+    void decode(std::uint32_t id, std::vector<std::uint32_t>& positions) const; // Replaces positions with the posting list of term id
+    static void encode(const std::uint32_t* positions, std::size_t count, std::vector<std::uint8_t>& bytes);
+
+    WordStoreColumn<char> termChars;
+    WordStoreColumn<std::uint64_t> termOffsets;    // termCount() + 1 entries, like WordStore::nameOffsets
+    WordStoreColumn<std::uint64_t> postingOffsets; // termCount() + 1 entries into postingBytes
+    WordStoreColumn<std::uint8_t> postingBytes;
+    WordIndex termIndex; // Lowercased term to term id
+    std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> added; // Entries inserted since the lists were encoded, by term id
+    std::shared_ptr<const void> externalOwner;
+};
+
+template <typename DefinitionAt>
+void DefinitionIndex::build(std::size_t entryCount, DefinitionAt definitionAt) {
+    clear();
+
+    // First pass: give every term an id and count the entries using it
+    std::vector<std::uint32_t> counts;
+    std::vector<std::uint32_t> lastEntry; // Newest entry counted for each term, so repeats in one definition count once
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        Tokenizer::forEach(definitionAt(i), [&](std::string_view token) {
+            const std::string_view normalized = Tokenizer::normalizeTerm(token);
+            if (normalized.empty()) {
+                return;
+            }
+            const std::uint32_t id = addTerm(normalized);
+            if (id == counts.size()) {
+                counts.push_back(0);
+                lastEntry.push_back(WordIndex::npos);
+            }
+            if (lastEntry[id] != i) {
+                lastEntry[id] = static_cast<std::uint32_t>(i);
+                ++counts[id];
+            }
+        });
+    }
+
+    // Second pass: lay the positions out term by term, then encode every list
+    std::vector<std::uint64_t> starts(counts.size() + 1, 0);
+    for (std::size_t id = 0; id < counts.size(); ++id) {
+        starts[id + 1] = starts[id] + counts[id];
+    }
+    std::vector<std::uint32_t> positions(starts.back());
+    std::vector<std::uint64_t> filled(starts.begin(), starts.end() - 1);
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        Tokenizer::forEach(definitionAt(i), [&](std::string_view token) {
+            const std::string_view normalized = Tokenizer::normalizeTerm(token);
+            if (normalized.empty()) {
+                return;
+            }
+            const std::uint32_t id = findTerm(normalized);
+            if (filled[id] == starts[id] || positions[filled[id] - 1] != i) {
+                positions[filled[id]++] = static_cast<std::uint32_t>(i);
+            }
+        });
+    }
+
+    std::vector<std::uint8_t>& bytes = postingBytes.values();
+    std::vector<std::uint64_t>& offsets = postingOffsets.values();
+    bytes.reserve(positions.size() + positions.size() / 2);
+    offsets.reserve(counts.size() + 1);
+    for (std::size_t id = 0; id < counts.size(); ++id) {
+        encode(positions.data() + starts[id], counts[id], bytes);
+        offsets.push_back(bytes.size());
+    }
+    bytes.shrink_to_fit();
+}
+
+#endif // DEFINITIONINDEX_H
@@ -25,52 +25,298 @@
 // - Error handling is included for invalid menu choices and file loading failures.
 
 #include "Dictionary.h"
+#include "CaseFold.h"
+#include "DictionaryParser.h"
+#include "MappedFile.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <iterator>
+#include <limits>
+#include <thread>
+
+namespace {
+
+const std::size_t minimumChunkBytes = 1 << 20; // Smaller chunks are not worth a thread
+
+} // namespace
+
+Dictionary::Dictionary(const Dictionary& other) // - The copy constructor copies every member, placing the copied words in this dictionary's arena.
+        : store(other.store), compact(other.compact), storageMode(other.storageMode), index(other.index), loadThreads(other.loadThreads) {
+    words.reserve(other.words.size());
+    for (const auto& word : other.words) {
+        words.emplace_back(word.getName(), word.getType(), word.getDefinition(), &arenas.main());
+    }
+}
+
+Dictionary& Dictionary::operator=(const Dictionary& other) { // - The copy assignment builds a whole copy and moves it in, so repeated copies never pile up in one arena.
+    if (this != &other) {
+        Dictionary copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
 
 bool Dictionary::loadFile(const std::string& filename) { // - The loadFromFile function reads a dictionary file (in a specific format) and populates
+    MappedFile mapped;
+    if (!mapped.open(filename)) {
+        return loadStream(filename); // Pipes, empty files and platforms without mmap use the stream reader
+    }
+
+    clearEntries();  // Clear existing words before loading new file
+    if (!loadBuffer(mapped.view())) {
+        std::cerr << "Too many distinct word types in file: " << filename << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool Dictionary::loadBuffer(std::string_view buffer) { // - The loadBuffer function parses the mapped file without copying lines, only the final fields are copied into storage.
+    std::size_t threadCount = loadThreads != 0 ? loadThreads : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min(threadCount, std::max<std::size_t>(1, buffer.size() / minimumChunkBytes));
+    if (threadCount > 1) {
+        return loadBufferParallel(buffer, threadCount);
+    }
+
+    bool stored = true;
+    DictionaryParser::parse(buffer, [this, &stored](const RecordView& record) {
+        if (!stored) {
+            return;
+        }
+        stored = appendEntry(record.name, record.type, record.definition, true);
+    });
+    if (compact) {
+        finishStore();
+    }
+    return stored;
+}
+
+bool Dictionary::loadBufferParallel(std::string_view buffer, std::size_t threadCount) { // - The loadBufferParallel function gives each thread its own chunk and storage, then joins the pieces in file order.
+    const std::vector<std::string_view> chunks = DictionaryParser::splitRecords(buffer, threadCount);
+    std::vector<std::thread> workers;
+    workers.reserve(chunks.size());
+
+    if (compact) {
+        std::vector<WordStore> parts(chunks.size());
+        std::vector<char> stored(chunks.size(), 1);
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back([&chunks, &parts, &stored, i]() {
+                DictionaryParser::parse(chunks[i], [&](const RecordView& record) {
+                    if (stored[i]) {
+                        stored[i] = parts[i].append(record.name, record.type, record.definition, true);
+                    }
+                });
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            if (!stored[i] || !store.appendStore(parts[i])) {
+                return false;
+            }
+            parts[i].clear(); // Release each piece as soon as it is copied
+        }
+        finishStore();
+    } else {
+        std::vector<std::vector<Word>> parts(chunks.size());
+        std::vector<Arena*> partArenas(chunks.size()); // An arena per thread, all owned by the dictionary
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            partArenas[i] = &arenas.add();
+        }
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            workers.emplace_back([&chunks, &parts, &partArenas, i]() {
+                DictionaryParser::parse(chunks[i], [&](const RecordView& record) {
+                    parts[i].emplace_back(record.name, record.type, record.definition, partArenas[i]).lowercaseName();
+                });
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        std::size_t total = words.size();
+        for (const auto& part : parts) {
+            total += part.size();
+        }
+        words.reserve(total);
+        for (auto& part : parts) {
+            std::move(part.begin(), part.end(), std::back_inserter(words));
+        }
+    }
+
+    // The index is filled in file order, so the first of several equal names still wins
+    index.reserve(wordCount());
+    for (std::size_t i = 0; i < wordCount(); ++i) {
+        index.insert(static_cast<std::uint32_t>(i), nameAt(i), [this](std::uint32_t position) { return nameAt(position); });
+    }
+    return true;
+}
+
+bool Dictionary::loadStream(const std::string& filename) { // - The loadStream function reads the file line by line for inputs that cannot be mapped.
     std::ifstream file(filename);
     if (!file.is_open()) {
         std::cerr << "Error opening file: " << filename << "\n";
         return false;
     }
 
-    words.clear();  // Clear existing words before loading new file
+    clearEntries();  // Clear existing words before loading new file
 
     std::string line;
-    Word word;
+    std::string type;
+    std::string definition;
     while (getline(file, line)) {
         line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
+        const std::string_view view(line);
         if (line.find("Type: ") == 0) {
-            word.setType(line.substr(6));
+            type.assign(view.substr(6));
         } else if (line.find("Definition: ") == 0) {
-            word.setDefinition(line.substr(12));
+            definition.assign(view.substr(12));
         } else if (line.find("Word: ") == 0) {
-            word.setName(line.substr(6));
-            words.push_back(word);
-            word = Word();  // Reset word for next entry
+            if (!appendEntry(view.substr(6), type, definition, true)) {
+                std::cerr << "Too many distinct word types in file: " << filename << "\n";
+                return false;
+            }
+            type.clear();  // Reset the fields for the next entry
+            definition.clear();
         }
     }
+    if (compact) {
+        finishStore();
+    }
 
     file.close();
     return true;
 }
 
 bool Dictionary::searchWord(const std::string& searchWord, Word& locatedWord) const { // - The searchWord function searches for a word in the words vector and returns true if found.
-    std::string lowerSearchWord = searchWord;
-    std::transform(lowerSearchWord.begin(), lowerSearchWord.end(), lowerSearchWord.begin(), ::tolower);
+    // The index lowercases the query while hashing it, so a miss never allocates
+    std::uint32_t position = index.find(searchWord, [this](std::uint32_t i) { return nameAt(i); });
+    if (position == WordIndex::npos) {
+        return false;
+    }
+    copyWordAt(position, locatedWord); // Reuses locatedWord's buffers instead of building a temporary Word
+    return true;
+}
+
+Word Dictionary::wordAt(std::size_t position) const { // - The wordAt function returns a copy of the entry at position.
+    if (!compact) {
+        return words[position];
+    }
+    return Word(store.name(position), store.type(position), store.definition(position));
+}
+
+bool Dictionary::appendWord(Word&& word) { // - The appendWord function moves a word into the active storage and the lookup index.
+    if (compact) {
+        return appendEntry(word.getName(), word.getType(), word.getDefinition(), false);
+    }
+
+    const auto position = static_cast<std::uint32_t>(words.size());
+    words.push_back(std::move(word));
+    index.insert(position, words.back().getName(), [this](std::uint32_t i) { return nameAt(i); });
+    return true;
+}
+
+bool Dictionary::appendEntry(std::string_view name, std::string_view type, std::string_view definition, bool lowercaseName) { // - The appendEntry function constructs the entry directly in the active storage.
+    if (compact) {
+        if (!store.append(name, type, definition, lowercaseName)) { // A mapped store is copied into owned columns here
+            return false;
+        }
+    } else {
+        Word& stored = words.emplace_back(name, type, definition, &arenas.main());
+        if (lowercaseName) {
+            stored.lowercaseName();
+        }
+    }
+
+    const auto position = static_cast<std::uint32_t>(wordCount() - 1);
+    index.insert(position, nameAt(position), [this](std::uint32_t i) { return nameAt(i); });
+    return true;
+}
+
+void Dictionary::finishStore() { // - The finishStore function packs the definitions if they are to be compressed, then releases spare column capacity.
+    if (storageMode == StorageMode::Compressed) {
+        store.compressDefinitions();
+    }
+    store.shrinkToFit();
+}
+
+void Dictionary::clearEntries() { // - The clearEntries function empties both layouts and the index, then selects the configured layout.
+    words.clear();
+    words.shrink_to_fit();
+    arenas.release(); // After the words, which point into it
+    store.clear();
+    index.clear();
+    compact = storageMode != StorageMode::Words;
+}
 
+bool Dictionary::adoptSnapshot(const std::shared_ptr<const DictionarySnapshot>& mapped, WordStore&& mappedStore) { // - The adoptSnapshot function points the dictionary at the columns and name index of a mapped snapshot.
+    DictionarySnapshot::SectionData slots;
+    if (!mapped->section(DictionarySnapshot::Section::NameIndex, slots)) {
+        return false;
+    }
+
+    WordIndex mappedIndex;
+    if (!mappedIndex.attach(static_cast<const WordIndex::Slot*>(slots.data), slots.size / sizeof(WordIndex::Slot), mapped->size(), mapped)) {
+        return false;
+    }
+
+    clearEntries();
+    store = std::move(mappedStore);
+    index = std::move(mappedIndex);
+    compact = true; // Snapshots are always served from the column layout, whatever storageMode says
+    return true;
+}
+
+void Dictionary::setStorageMode(StorageMode mode) { // - The setStorageMode function converts loaded entries to the requested layout; positions do not change.
+    storageMode = mode;
+    const bool wantCompact = mode != StorageMode::Words;
+    if (wantCompact && !compact) {
+        WordStore converted;
+        for (const auto& word : words) {
+            if (!converted.append(word.getName(), word.getType(), word.getDefinition())) {
+                storageMode = StorageMode::Words; // Cannot represent this many types, stay as we are
+                return;
+            }
+        }
+        store = std::move(converted);
+        words.clear();
+        words.shrink_to_fit();
+        arenas.release();
+    } else if (!wantCompact && compact) {
+        words.clear();
+        words.reserve(store.size());
+        for (std::size_t i = 0; i < store.size(); ++i) {
+            words.emplace_back(store.name(i), store.type(i), store.definition(i), &arenas.main());
+        }
+        store.clear();
+    }
+    compact = wantCompact;
+
+    if (mode == StorageMode::Compressed) {
+        store.compressDefinitions();
+    } else if (mode == StorageMode::Compact && !store.decompressDefinitions()) {
+        std::cerr << "Could not decompress the dictionary definitions.\n";
+    }
+}
+
+std::size_t Dictionary::storageMemoryUsage() const { // - The storageMemoryUsage function counts the vector, the arena chunks and any heap strings for words, or the column sizes for store.
+    if (compact) {
+        return store.memoryUsage();
+    }
+
+    const std::size_t inlineCapacity = std::pmr::string().capacity(); // Short strings live inside the string object
+    std::size_t bytes = words.capacity() * sizeof(Word) + arenas.capacity();
     for (const auto& word : words) {
-        if (word.getName() == lowerSearchWord) {
-            locatedWord = word;
-            return true;
+        for (const std::pmr::string* field : {&word.getName(), &word.getType(), &word.getDefinition()}) {
+            if (field->capacity() > inlineCapacity && dynamic_cast<const Arena*>(field->get_allocator().resource()) == nullptr) { // Arena strings are in the chunks already
+                bytes += field->capacity() + 1;
+            }
         }
     }
-    return false;
+    return bytes;
 }
 
-std::string Dictionary::typeConversion(const std::string& type) const { // - The typeConversion function converts a single-character type code (n, v, adj) to a full word type.
+std::string Dictionary::typeConversion(std::string_view type) const { // - The typeConversion function converts a single-character type code (n, v, adj) to a full word type.
     if (type == "n") return "Noun";
     if (type == "v") return "Verb";
     if (type == "adj") return "Adjective";
@@ -117,7 +363,7 @@ void Dictionary::menu() { // - The menu function continuously displays a menu un
                 Word locatedWord;
                 std::cout << "Enter a word to search: ";
                 std::cin >> wordToLocate;
-                std::transform(wordToLocate.begin(), wordToLocate.end(), wordToLocate.begin(), ::tolower);
+                CaseFold::toLower(wordToLocate.data(), wordToLocate.size());
 
                 if (searchWord(wordToLocate, locatedWord)) {
                     locatedWord.printDefinition();
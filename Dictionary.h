@@ -20,23 +20,81 @@
 // parameter is used to pass the Word object back.
 // The typeConversion function returns a string representing the converted (n -> noun).
 // The menu function displays a menu to the user and interacts with the dictionary accordingly (not used after ImprovedDictionary class).
+// The wordCount, nameAt, typeAt, definitionAt, definitionSizeAt and wordAt functions read entries by position, whether they are
+// stored in the words vector or in a WordStore (the compact column layout, also used for mapped snapshots).
+// The setStorageMode function chooses between the layouts, and storageMemoryUsage reports the bytes used.
+// In the Compressed layout a view returned by definitionAt stays valid until the same thread reads another
+// definition, so callers copy or use it before reading the next one.
+// The setLoadThreads function sets how many threads parse a mapped file; the entries and their order are the
+// same for any thread count.
+// In the Words layout the strings of every loaded entry live in the dictionary's arenas (see Arena.h), so a
+// load makes a few chunk allocations instead of one per string, and clearing or destroying the dictionary
+// frees them together. Copies place their strings in arenas of their own; words added one at a time keep the
+// heap strings they were built with.
 //
 #ifndef DICTIONARY_H
 #define DICTIONARY_H
 
+#include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
+#include "Arena.h"
+#include "DictionarySnapshot.h"
 #include "Word.h"
+#include "WordIndex.h"
+#include "WordStore.h"
+
+enum class StorageMode {
+    Words,      // One Word object (three std::pmr::strings in the dictionary's arenas) per entry
+    Compact,    // WordStore columns: two character arenas, offsets and one byte type codes
+    Compressed, // WordStore columns with the definitions in compressed blocks (see CompressedText)
+};
 
 class Dictionary {
 protected:
+    ArenaSet arenas; // Holds the strings in words, declared first so the words are destroyed before it
     std::vector<Word> words;
+    WordStore store; // Column storage, used instead of words while compact is set (Compact and Compressed).
+    bool compact = false;
+    StorageMode storageMode = StorageMode::Words; // Layout used when a text file is loaded
+    WordIndex index; // Hash index over the lowercased names, kept in step with every insert.
+    unsigned loadThreads = 1; // Parser threads for mapped files, 0 means one per hardware thread
+
+    bool appendWord(Word&& word); // The appendWord function moves a word into the active storage and the lookup index.
+    bool appendEntry(std::string_view name, std::string_view type, std::string_view definition, bool lowercaseName); // The appendEntry function builds an entry in place from its fields.
+    bool adoptSnapshot(const std::shared_ptr<const DictionarySnapshot>& mapped, WordStore&& mappedStore); // The adoptSnapshot function serves entries and lookups straight from a mapped snapshot, whose columns mappedStore is already attached to.
+    void clearEntries(); // The clearEntries function empties the storage and index before a load.
+    bool loadBuffer(std::string_view buffer); // The loadBuffer function parses an in-memory (mapped) dictionary file in place.
+    bool loadBufferParallel(std::string_view buffer, std::size_t threadCount); // The loadBufferParallel function parses record-aligned chunks on several threads.
+    bool loadStream(const std::string& filename); // The loadStream function is the getline based loader, used when a file cannot be mapped.
+    void finishStore(); // The finishStore function trims the columns after a load and compresses them in the Compressed layout.
 
 public:
+    Dictionary() = default;
+    Dictionary(const Dictionary& other); // Copies the words into this dictionary's arena.
+    Dictionary(Dictionary&&) = default;
+    Dictionary& operator=(const Dictionary& other); // Builds a fresh copy, so the old arenas are freed instead of reused.
+    Dictionary& operator=(Dictionary&&) = default;
+
     bool loadFile(const std::string& filename); // The loadFromFile function reads a dictionary file (in a specific format) and populates the words vector.
     bool searchWord(const std::string& searchWord, Word& locatedWord) const; // The searchWord function searches for a word in the words vector and returns true if found.
     void menu(); // The menu function continuously displays a menu until the user chooses to exit.
-    std::string typeConversion(const std::string& type) const; // The typeConversion function converts a single-character type code (n, v, adj) to a full word type.
+    std::string typeConversion(std::string_view type) const; // The typeConversion function converts a single-character type code (n, v, adj) to a full word type.
+
+    void setStorageMode(StorageMode mode); // The setStorageMode function switches layouts, converting any loaded entries.
+    std::size_t storageMemoryUsage() const; // The storageMemoryUsage function returns the heap bytes held by the entries (indexes excluded).
+    void setLoadThreads(unsigned threads) { loadThreads = threads; } // 1 parses serially, 0 uses every hardware thread.
+    StorageMode getStorageMode() const { return storageMode; }
+    unsigned getLoadThreads() const { return loadThreads; }
+
+    std::size_t wordCount() const { return compact ? store.size() : words.size(); }
+    std::string_view nameAt(std::size_t position) const { return compact ? store.name(position) : std::string_view(words[position].getName()); }
+    std::string_view typeAt(std::size_t position) const { return compact ? store.type(position) : std::string_view(words[position].getType()); }
+    std::string_view definitionAt(std::size_t position) const { return compact ? store.definition(position) : std::string_view(words[position].getDefinition()); }
+    std::size_t definitionSizeAt(std::size_t position) const { return compact ? store.definitionSize(position) : words[position].getDefinition().size(); } // Never decompresses a definition.
+    Word wordAt(std::size_t position) const; // The wordAt function returns a copy of the entry at position.
+    void copyWordAt(std::size_t position, Word& out) const { out.assign(nameAt(position), typeAt(position), definitionAt(position)); }
 };
 
 #endif // DICTIONARY_H
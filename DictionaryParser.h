@@ -0,0 +1,101 @@
+// File: DictionaryParser.h
+// Summary:
+// This file defines the DictionaryParser, which scans a dictionary held in memory (for
+// example a MappedFile) in the "Type: / Definition: / Word: " format without copying it.
+// Every record is reported as a RecordView whose fields point straight into the buffer.
+//
+// Input:
+// - The parse function takes the whole file contents as a string view and a callable that
+//   is invoked once per record.
+//
+// Output:
+// - The callable receives a RecordView for every "Word: " line, carrying the most recent
+//   "Type: " and "Definition: " values seen since the previous record, exactly as the
+//   getline based Dictionary::loadFile assigns them.
+// - Trailing '\r' characters are excluded from each line, so CRLF files are handled without
+//   rewriting the buffer.
+// - splitRecords cuts a buffer into chunks that each end just after a "Word: " line. A record
+//   is complete once its "Word: " line is read, so every chunk parses on its own and the
+//   chunks, parsed in order, give exactly the records of the whole buffer.
+//
+#ifndef DICTIONARYPARSER_H
+#define DICTIONARYPARSER_H
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+struct RecordView {
+    std::string_view type;
+    std::string_view definition;
+    std::string_view name;
+};
+
+class DictionaryParser {
+public:
+    template <typename OnRecord>
+    static void parse(std::string_view buffer, OnRecord onRecord); // The parse function reports every record in buffer in file order.
+
+    static std::string_view nextLine(std::string_view buffer, std::size_t& position); // Returns the line at position (without "\r\n") and moves past it.
+    static std::vector<std::string_view> splitRecords(std::string_view buffer, std::size_t chunkCount); // Splits buffer into at most chunkCount record-aligned chunks.
+    static bool isWordLine(std::string_view line) { return line.size() >= 6 && line.compare(0, 6, "Word: ") == 0; }
+};
+
+inline std::string_view DictionaryParser::nextLine(std::string_view buffer, std::size_t& position) {
+    const char* begin = buffer.data() + position;
+    const std::size_t remaining = buffer.size() - position;
+    const char* newline = static_cast<const char*>(std::memchr(begin, '\n', remaining));
+
+    std::size_t length = newline ? static_cast<std::size_t>(newline - begin) : remaining;
+    position += newline ? length + 1 : length;
+
+    while (length > 0 && begin[length - 1] == '\r') {
+        --length;
+    }
+    return std::string_view(begin, length);
+}
+
+template <typename OnRecord>
+void DictionaryParser::parse(std::string_view buffer, OnRecord onRecord) {
+    RecordView record;
+    std::size_t position = 0;
+    while (position < buffer.size()) {
+        std::string_view line = nextLine(buffer, position);
+        if (line.size() >= 6 && line.compare(0, 6, "Type: ") == 0) {
+            record.type = line.substr(6);
+        } else if (line.size() >= 12 && line.compare(0, 12, "Definition: ") == 0) {
+            record.definition = line.substr(12);
+        } else if (isWordLine(line)) {
+            record.name = line.substr(6);
+            onRecord(record);
+            record = RecordView();  // Reset record for next entry
+        }
+    }
+}
+
+inline std::vector<std::string_view> DictionaryParser::splitRecords(std::string_view buffer, std::size_t chunkCount) {
+    std::vector<std::string_view> chunks;
+    std::size_t chunkStart = 0;
+    for (std::size_t chunk = 1; chunk < chunkCount && chunkStart < buffer.size(); ++chunk) {
+        std::size_t position = std::max(chunkStart, buffer.size() / chunkCount * chunk);
+
+        // Move to the start of a line, then on to the end of the next "Word: " line
+        if (position > 0 && buffer[position - 1] != '\n') {
+            nextLine(buffer, position);
+        }
+        while (position < buffer.size() && !isWordLine(nextLine(buffer, position))) {
+        }
+
+        if (position > chunkStart) {
+            chunks.push_back(buffer.substr(chunkStart, position - chunkStart));
+            chunkStart = position;
+        }
+    }
+    if (chunkStart < buffer.size()) {
+        chunks.push_back(buffer.substr(chunkStart));
+    }
+    return chunks;
+}
+
+#endif // DICTIONARYPARSER_H
@@ -0,0 +1,163 @@
+// File: DictionarySnapshot.cpp
+// Summary:
+// This file implements reading and writing of compiled dictionary snapshots.
+//
+// Input:
+// - Snapshot file names for open and isSnapshotFile.
+// - The entry count and the sections handed to the Builder.
+//
+// Output:
+// - A validated, mapped snapshot, or an error message on standard error.
+// - A snapshot file written by Builder::write.
+//
+// Comments:
+// - Validation only checks the header and the section table, so opening a snapshot does not
+//   touch the entries' text. Each index checks its own sections when it attaches them, once
+//   and in one pass: offsets stay in range and in order, and every position names an entry.
+// - Builder::write replaces the file by rename (see AtomicFile), never in place, because
+//   dictionaries loaded from a snapshot keep the old file mapped.
+//
+#include "DictionarySnapshot.h"
+#include "AtomicFile.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+const char snapshotMagic[8] = {'D', 'I', 'C', 'T', 'S', 'N', 'A', 'P'};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t sectionCount;
+    std::uint64_t entryCount;
+    std::uint64_t fileSize;
+};
+
+struct SectionHeader {
+    std::uint32_t id;
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint64_t count;
+};
+
+std::uint64_t alignTo8(std::uint64_t value) {
+    return (value + 7) & ~std::uint64_t(7);
+}
+
+const SectionHeader* sectionTable(const MappedFile& file) {
+    return reinterpret_cast<const SectionHeader*>(file.data() + sizeof(FileHeader));
+}
+
+} // namespace
+
+bool DictionarySnapshot::isSnapshotFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(snapshotMagic)] = {};
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, snapshotMagic, sizeof(magic)) == 0;
+}
+
+bool DictionarySnapshot::open(const std::string& filename) {
+    if (!file.open(filename, MappedFile::Access::Random)) {
+        std::cerr << "Error opening file: " << filename << "\n";
+        return false;
+    }
+
+    FileHeader header;
+    if (file.size() < sizeof(header)) {
+        std::cerr << "Snapshot is truncated: " << filename << "\n";
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0) {
+        std::cerr << "Not a dictionary snapshot: " << filename << "\n";
+        return false;
+    }
+    if (header.version != formatVersion) {
+        std::cerr << "Unsupported snapshot version " << header.version << " (expected " << formatVersion
+                  << "), recompile " << filename << "\n";
+        return false;
+    }
+    if (header.fileSize != file.size()
+        || sizeof(FileHeader) + std::uint64_t(header.sectionCount) * sizeof(SectionHeader) > file.size()) {
+        std::cerr << "Snapshot is truncated: " << filename << "\n";
+        return false;
+    }
+
+    const SectionHeader* table = sectionTable(file);
+    for (std::uint32_t i = 0; i < header.sectionCount; ++i) {
+        if (table[i].offset % 8 != 0 || table[i].offset > file.size() || table[i].size > file.size() - table[i].offset) {
+            std::cerr << "Snapshot has a corrupt section table: " << filename << "\n";
+            return false;
+        }
+    }
+
+    entryCount = static_cast<std::size_t>(header.entryCount);
+    return true;
+}
+
+bool DictionarySnapshot::section(Section id, SectionData& out) const {
+    if (!file.isOpen()) {
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    const SectionHeader* table = sectionTable(file);
+    for (std::uint32_t i = 0; i < header.sectionCount; ++i) {
+        if (table[i].id == static_cast<std::uint32_t>(id)) {
+            out.data = file.data() + table[i].offset;
+            out.size = table[i].size;
+            out.count = table[i].count;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DictionarySnapshot::Builder::addSection(Section id, const void* data, std::size_t size, std::uint64_t count) {
+    const char* bytes = static_cast<const char*>(data);
+    sections.push_back(PendingSection{id, std::vector<char>(bytes, bytes + size), count});
+}
+
+// - Builder::write(filename): Writes through an AtomicFile, so a snapshot that is mapped and
+//   being served is replaced by rename and its pages never change under the readers.
+bool DictionarySnapshot::Builder::write(const std::string& filename) const {
+    AtomicFile out(filename);
+    if (!out.open()) {
+        std::cerr << "Error opening file: " << filename << "\n";
+        return false;
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = formatVersion;
+    header.sectionCount = static_cast<std::uint32_t>(sections.size());
+    header.entryCount = entryCount;
+
+    std::vector<SectionHeader> table(sections.size());
+    std::uint64_t offset = alignTo8(sizeof(FileHeader) + table.size() * sizeof(SectionHeader));
+    for (std::size_t i = 0; i < sections.size(); ++i) {
+        table[i] = SectionHeader{static_cast<std::uint32_t>(sections[i].id), 0, offset, sections[i].bytes.size(), sections[i].count};
+        offset = alignTo8(offset + sections[i].bytes.size());
+    }
+    header.fileSize = offset;
+
+    const char padding[8] = {};
+    std::uint64_t written = sizeof(FileHeader) + table.size() * sizeof(SectionHeader);
+    bool ok = out.write(std::string_view(reinterpret_cast<const char*>(&header), sizeof(header)))
+              && out.write(std::string_view(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SectionHeader)));
+    for (std::size_t i = 0; ok && i < sections.size(); ++i) {
+        ok = out.write(std::string_view(padding, static_cast<std::size_t>(table[i].offset - written)))
+             && out.write(std::string_view(sections[i].bytes.data(), sections[i].bytes.size()));
+        written = table[i].offset + sections[i].bytes.size();
+    }
+    ok = ok && out.write(std::string_view(padding, static_cast<std::size_t>(header.fileSize - written))) && out.commit();
+    if (!ok) {
+        std::cerr << "Error writing file: " << filename << "\n";
+    }
+    return ok;
+}
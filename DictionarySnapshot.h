@@ -0,0 +1,106 @@
+// File: DictionarySnapshot.h
+// Summary:
+// This file defines the DictionarySnapshot class, a compiled binary form of a dictionary
+// that can be memory mapped and used directly. A snapshot holds the WordStore columns (the
+// name and definition arenas, their offsets and the type codes) and the prebuilt lookup
+// indexes, so opening it involves no parsing and no per-entry allocation.
+//
+// Layout (all integers little-endian, every section 8-byte aligned):
+// - Header: the magic "DICTSNAP", the format version, the number of sections and entries,
+//   and the total file size.
+// - Section table: one SectionHeader (id, offset, size in bytes, item count) per section.
+// - Sections: the WordStore columns (NameChars, NameOffsets, DefinitionChars,
+//   DefinitionOffsets, Types and TypeNames, see WordStore.h), NameIndex (the WordIndex
+//   slots, which refer to entries by position), SuffixIndex (entry positions sorted by
+//   reversed name, used for rhymes), PalindromeIndex (the PalindromeIndex table of
+//   palindromes by first letter), and PrefixOrder and PrefixNodes (the PrefixIndex sorted
+//   positions and trie nodes, used for autocomplete), and FuzzyPostings and FuzzyBuckets (the
+//   FuzzyIndex deletion postings and bucket starts, used for "did you mean" suggestions).
+// - TermChars, TermOffsets, TermIndex, PostingOffsets and PostingBytes hold the
+//   DefinitionIndex: the definition terms, a WordIndex over them and their posting lists.
+// - ClozeQuestions holds the ClozeIndex questions of the guessing game.
+//
+// Input:
+// - open takes the name of a snapshot file written by DictionarySnapshot::Builder.
+// - The Builder takes the number of entries and every section to store.
+//
+// Output:
+// - open returns True if the file was mapped and its header and section table are valid.
+//   Errors are printed to standard error in the same way as Dictionary::loadFile.
+// - section returns a view of one mapped section.
+// - Builder::write returns True if the snapshot file was written. It writes a temporary file and
+//   renames it over the target, so processes that have the old snapshot mapped keep reading it.
+//
+#ifndef DICTIONARYSNAPSHOT_H
+#define DICTIONARYSNAPSHOT_H
+
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class DictionarySnapshot {
+public:
+    static constexpr std::uint32_t formatVersion = 8; // Bump whenever the layout, a section or the WordIndex hash changes
+
+    enum class Section : std::uint32_t {
+        NameChars = 1,
+        NameOffsets = 2,
+        NameIndex = 3,
+        SuffixIndex = 4,
+        PalindromeIndex = 5,
+        DefinitionChars = 6,
+        DefinitionOffsets = 7,
+        Types = 8,
+        TypeNames = 9,
+        PrefixOrder = 10,
+        PrefixNodes = 11,
+        FuzzyPostings = 12,
+        FuzzyBuckets = 13,
+        TermChars = 14,
+        TermOffsets = 15,
+        TermIndex = 16,
+        PostingOffsets = 17,
+        PostingBytes = 18,
+        ClozeQuestions = 19,
+    };
+
+    struct SectionData {
+        const void* data = nullptr;
+        std::uint64_t size = 0;  // Size in bytes
+        std::uint64_t count = 0; // Number of items the section describes
+    };
+
+    class Builder;
+
+    static bool isSnapshotFile(const std::string& filename); // The isSnapshotFile function checks the magic bytes at the start of a file.
+    bool open(const std::string& filename); // The open function maps a snapshot file and validates its header.
+
+    std::size_t size() const { return entryCount; } // Number of dictionary entries in the snapshot
+    bool section(Section id, SectionData& out) const; // The section function finds a section, returning False if it is absent.
+
+private:
+    MappedFile file;
+    std::size_t entryCount = 0;
+};
+
+class DictionarySnapshot::Builder {
+public:
+    explicit Builder(std::size_t entryCount) : entryCount(entryCount) {}
+
+    void addSection(Section id, const void* data, std::size_t size, std::uint64_t count); // The addSection function stores a section, the bytes are copied.
+    bool write(const std::string& filename) const; // The write function writes the snapshot file.
+
+private:
+    struct PendingSection {
+        Section id;
+        std::vector<char> bytes;
+        std::uint64_t count;
+    };
+
+    std::size_t entryCount;
+    std::vector<PendingSection> sections;
+};
+
+#endif // DICTIONARYSNAPSHOT_H
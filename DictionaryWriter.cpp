@@ -0,0 +1,85 @@
+// File: DictionaryWriter.cpp
+// Summary:
+// This file implements the DictionaryWriter class: formatting one record, formatting a range
+// of entries into a buffer, and writing the whole dictionary window by window.
+//
+// Input:
+// - A Dictionary read through its positional accessors.
+//
+// Output:
+// - The dictionary text, in buffers or in the AtomicFile given.
+//
+#include "DictionaryWriter.h"
+#include "AtomicFile.h"
+#include "Dictionary.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view typeLabel = "Type: ";
+constexpr std::string_view definitionLabel = "\nDefinition: ";
+constexpr std::string_view wordLabel = "\nWord: ";
+constexpr std::string_view recordEnd = "\n\n";
+
+char* put(char* out, std::string_view text) {
+    std::memcpy(out, text.data(), text.size());
+    return out + text.size();
+}
+
+} // namespace
+
+std::size_t DictionaryWriter::recordSize(std::string_view name, std::string_view type, std::size_t definitionSize) {
+    return typeLabel.size() + type.size() + definitionLabel.size() + definitionSize + wordLabel.size() + name.size()
+           + recordEnd.size();
+}
+
+char* DictionaryWriter::formatRecord(char* out, std::string_view name, std::string_view type, std::string_view definition) {
+    out = put(out, typeLabel);
+    out = put(out, type);
+    out = put(out, definitionLabel);
+    out = put(out, definition);
+    out = put(out, wordLabel);
+    out = put(out, name);
+    return put(out, recordEnd);
+}
+
+void DictionaryWriter::format(const Dictionary& dictionary, std::size_t begin, std::size_t end, std::string& out) {
+    std::size_t size = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+        size += recordSize(dictionary.nameAt(i), dictionary.typeAt(i), dictionary.definitionSizeAt(i));
+    }
+    out.resize(size); // Keeps the capacity of a reused buffer
+    char* cursor = out.data();
+    for (std::size_t i = begin; i < end; ++i) {
+        cursor = formatRecord(cursor, dictionary.nameAt(i), dictionary.typeAt(i), dictionary.definitionAt(i));
+    }
+}
+
+// - write(const Dictionary& dictionary, AtomicFile& file): Formats one window of chunks in
+//   parallel, writes its buffers in order, then moves on to the next window.
+bool DictionaryWriter::write(const Dictionary& dictionary, AtomicFile& file) {
+    ThreadPool& pool = ThreadPool::shared();
+    const std::size_t count = dictionary.wordCount();
+    const std::size_t chunkCount = (count + chunkEntries - 1) / chunkEntries;
+    const std::size_t windowChunks = std::min(chunkCount, (pool.workerCount() + 1) * chunksPerThread);
+    std::vector<std::string> buffers(windowChunks);
+
+    for (std::size_t first = 0; first < chunkCount; first += windowChunks) {
+        const std::size_t chunks = std::min(windowChunks, chunkCount - first);
+        pool.parallelFor(chunks, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t c = begin; c < end; ++c) {
+                const std::size_t entry = (first + c) * chunkEntries;
+                format(dictionary, entry, std::min(count, entry + chunkEntries), buffers[c]);
+            }
+        });
+        for (std::size_t c = 0; c < chunks; ++c) {
+            if (!file.write(buffers[c])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,49 @@
+// File: DictionaryWriter.h
+// Summary:
+// This file defines the DictionaryWriter class, which serializes a dictionary into the text
+// format that Dictionary::loadFile reads. Entries are formatted straight from the stored
+// views into large buffers, several chunks at a time on the thread pool, and each buffer is
+// handed to the file in one write.
+//
+// Input:
+// - A loaded Dictionary (or ImprovedDictionary) and an opened AtomicFile.
+//
+// Output:
+// - write appends every entry, in position order, as
+//     "Type: <type>\nDefinition: <definition>\nWord: <name>\n\n"
+//   which is byte for byte what saveDictionaryToFile wrote with std::ofstream on POSIX. On
+//   Windows lines now end in "\n" alone, which loadFile reads the same way.
+// - format produces the text of a range of entries into a string, for callers that keep it
+//   in memory.
+//
+// Comments:
+// - Memory is bounded: at most windowChunks buffers of chunkEntries entries each are alive
+//   at once, and they are reused from one window to the next, so saving a large dictionary
+//   does not hold a second copy of it.
+// - Formatting is a size pass followed by memcpys into a buffer sized once, so there is no
+//   per-field stream call and no reallocation while a chunk is written. The size pass takes
+//   definition sizes from the offsets, so each compressed definition is decoded once.
+//
+#ifndef DICTIONARYWRITER_H
+#define DICTIONARYWRITER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+class AtomicFile;
+class Dictionary;
+
+class DictionaryWriter {
+public:
+    static constexpr std::size_t chunkEntries = 16384; // Entries formatted by one task into one buffer
+    static constexpr std::size_t chunksPerThread = 2;  // Window size per thread of the pool
+
+    static std::size_t recordSize(std::string_view name, std::string_view type, std::size_t definitionSize);
+    static char* formatRecord(char* out, std::string_view name, std::string_view type, std::string_view definition); // Returns the end of the record.
+
+    static void format(const Dictionary& dictionary, std::size_t begin, std::size_t end, std::string& out); // Replaces out with entries begin to end - 1.
+    static bool write(const Dictionary& dictionary, AtomicFile& file); // Appends every entry to file.
+};
+
+#endif // DICTIONARYWRITER_H
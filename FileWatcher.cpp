@@ -0,0 +1,145 @@
+// File: FileWatcher.cpp
+// Summary:
+// This file implements the FileWatcher class with inotify on Linux and by polling the
+// file's size and modification time on other platforms.
+//
+// Input:
+// - The file to watch; its directory must exist.
+//
+// Output:
+// - Calls to the callback on the watcher thread, one per settled burst of changes.
+//
+#include "FileWatcher.h"
+#include <sys/stat.h>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+
+bool FileWatcher::start(const std::string& filename, std::function<void()> onChange) {
+    stop();
+    const std::size_t slash = filename.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : filename.substr(0, slash));
+
+    notifyFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (notifyFd < 0 || inotify_add_watch(notifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0
+        || pipe2(wakeFds, O_CLOEXEC) != 0) {
+        stop();
+        return false;
+    }
+    path = filename;
+    callback = std::move(onChange);
+    stopping = false;
+    watcher = std::thread(&FileWatcher::run, this);
+    return true;
+}
+
+void FileWatcher::stop() {
+    if (watcher.joinable()) {
+        stopping = true;
+        const char wake = 0;
+        const ssize_t woken = write(wakeFds[1], &wake, 1); // An empty pipe always takes one byte
+        (void)woken;
+        watcher.join();
+    }
+    for (int* fd : {&notifyFd, &wakeFds[0], &wakeFds[1]}) {
+        if (*fd >= 0) {
+            close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+void FileWatcher::run() {
+    const std::size_t slash = path.find_last_of('/');
+    const std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    bool changed = false; // A change was seen and the file has not been quiet for settleTime yet
+
+    while (!stopping) {
+        pollfd waitFor[2] = {{notifyFd, POLLIN, 0}, {wakeFds[0], POLLIN, 0}};
+        const int ready = poll(waitFor, 2, changed ? static_cast<int>(settleTime.count()) : -1);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready < 0 || (waitFor[1].revents & POLLIN)) {
+            break;
+        }
+        if (ready == 0) {
+            changed = false;
+            callback();
+            continue;
+        }
+
+        alignas(inotify_event) char events[sizeof(inotify_event) + NAME_MAX + 1];
+        ssize_t length;
+        while ((length = read(notifyFd, events, sizeof(events))) > 0) {
+            for (char* at = events; at < events + length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(at);
+                if (event->len > 0 && name == event->name) {
+                    changed = true;
+                }
+                at += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+}
+
+#else
+
+namespace {
+
+bool signature(const std::string& path, long long& size, long long& modified) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+    size = static_cast<long long>(info.st_size);
+    modified = static_cast<long long>(info.st_mtime);
+    return true;
+}
+
+} // namespace
+
+bool FileWatcher::start(const std::string& filename, std::function<void()> onChange) {
+    stop();
+    path = filename;
+    callback = std::move(onChange);
+    stopping = false;
+    watcher = std::thread(&FileWatcher::run, this);
+    return true;
+}
+
+void FileWatcher::stop() {
+    if (watcher.joinable()) {
+        stopping = true;
+        watcher.join();
+    }
+}
+
+void FileWatcher::run() {
+    long long size = -1, modified = -1;
+    signature(path, size, modified);
+    const auto step = std::chrono::milliseconds(50); // Keeps stop responsive between polls
+
+    while (!stopping) {
+        for (auto waited = std::chrono::milliseconds(0); waited < pollInterval && !stopping; waited += step) {
+            std::this_thread::sleep_for(step);
+        }
+        long long newSize = -1, newModified = -1;
+        if (stopping || !signature(path, newSize, newModified) || (newSize == size && newModified == modified)) {
+            continue;
+        }
+        std::this_thread::sleep_for(settleTime); // Let the writer finish, then take the settled signature
+        signature(path, size, modified);
+        callback();
+    }
+}
+
+#endif
@@ -0,0 +1,58 @@
+// File: FileWatcher.h
+// Summary:
+// This file defines the FileWatcher class, which runs a callback on its own thread whenever
+// a file is rewritten or replaced. ConcurrentDictionary uses it to reload a dictionary file
+// as soon as a new version is deployed.
+//
+// Input:
+// - start takes the file to watch and the callback to run.
+//
+// Output:
+// - The callback runs once per burst of changes, after the file has been quiet for
+//   settleTime, so a file that is still being written is not read half way. It runs on the
+//   watcher thread, never on two threads at once.
+//
+// Comments:
+// - On Linux the file's directory is watched with inotify, so writes that finish
+//   (IN_CLOSE_WRITE) and files renamed into place (IN_MOVED_TO) are both seen, as is a file
+//   that did not exist yet. Elsewhere the file's size and modification time are polled
+//   every pollInterval.
+// - The callback comes after the change, so it cannot protect readers of a file that is
+//   mapped: a mapped file (such as a served snapshot) must be replaced by rename, never
+//   rewritten in place.
+//
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+
+class FileWatcher {
+public:
+    static constexpr std::chrono::milliseconds settleTime{200};
+    static constexpr std::chrono::milliseconds pollInterval{1000};
+
+    FileWatcher() = default;
+    ~FileWatcher() { stop(); }
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    bool start(const std::string& filename, std::function<void()> onChange); // Returns false if the file's directory cannot be watched.
+    void stop(); // The stop function returns once the watcher thread has finished, it is safe to call more than once.
+    bool isRunning() const { return watcher.joinable(); }
+
+private:
+    void run();
+
+    std::string path;
+    std::function<void()> callback;
+    std::thread watcher;
+    std::atomic<bool> stopping{false};
+    int notifyFd = -1;       // inotify descriptor (Linux)
+    int wakeFds[2] = {-1, -1}; // Pipe that stop writes to, so the thread wakes without waiting for a timeout (Linux)
+};
+
+#endif // FILEWATCHER_H
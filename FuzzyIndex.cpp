@@ -0,0 +1,197 @@
+// File: FuzzyIndex.cpp
+// Summary:
+// This file implements the edit distance used by the FuzzyIndex class, the deletion hashes
+// it files words under, regrouping postings into buckets, and attaching the index to or
+// detaching it from borrowed storage.
+//
+// Input:
+// - Names as string views, compared after ASCII lowercasing.
+//
+// Output:
+// - EditDistance::to returns the Levenshtein distance. Patterns of up to 64 bytes (every
+//   ordinary word) use the bit-parallel algorithm of Myers and Hyyro, which handles one
+//   character of text per handful of word operations; longer ones use the textbook table.
+// - attach returns False if mapped bucket starts or postings point outside the tables.
+//
+#include "FuzzyIndex.h"
+#include "CaseFold.h"
+#include <cstring>
+#include <utility>
+
+namespace {
+
+unsigned char folded(char c) { // As an index into the match masks
+    return static_cast<unsigned char>(CaseFold::lower(c));
+}
+
+} // namespace
+
+EditDistance::EditDistance(std::string_view pattern) : pattern(pattern) {
+    std::memset(matches, 0, sizeof(matches));
+    if (pattern.size() <= 64) {
+        for (std::size_t i = 0; i < pattern.size(); ++i) {
+            matches[folded(pattern[i])] |= std::uint64_t(1) << i;
+        }
+    }
+}
+
+std::size_t EditDistance::to(std::string_view text) const {
+    const std::size_t m = pattern.size();
+    if (m == 0) {
+        return text.size();
+    }
+
+    if (m <= 64) {
+        // Each bit holds the vertical difference (+1 / -1) between neighbouring cells of the column
+        std::uint64_t positive = ~std::uint64_t(0);
+        std::uint64_t negative = 0;
+        const std::uint64_t last = std::uint64_t(1) << (m - 1);
+        std::size_t score = m;
+        for (char c : text) {
+            const std::uint64_t equal = matches[folded(c)];
+            const std::uint64_t verticalX = equal | negative;
+            const std::uint64_t horizontalX = (((equal & positive) + positive) ^ positive) | equal;
+            std::uint64_t horizontalPositive = negative | ~(horizontalX | positive);
+            std::uint64_t horizontalNegative = positive & horizontalX;
+            if (horizontalPositive & last) {
+                ++score;
+            } else if (horizontalNegative & last) {
+                --score;
+            }
+            horizontalPositive = (horizontalPositive << 1) | 1; // The top row grows by one per text character
+            horizontalNegative <<= 1;
+            positive = horizontalNegative | ~(verticalX | horizontalPositive);
+            negative = horizontalPositive & verticalX;
+        }
+        return score;
+    }
+
+    std::vector<std::size_t> row(text.size() + 1);
+    for (std::size_t j = 0; j <= text.size(); ++j) {
+        row[j] = j;
+    }
+    for (std::size_t i = 1; i <= m; ++i) {
+        std::size_t diagonal = row[0];
+        row[0] = i;
+        for (std::size_t j = 1; j <= text.size(); ++j) {
+            const std::size_t above = row[j];
+            const std::size_t substitution = diagonal + (CaseFold::lower(pattern[i - 1]) == CaseFold::lower(text[j - 1]) ? 0 : 1);
+            row[j] = std::min(std::min(above, row[j - 1]) + 1, substitution);
+            diagonal = above;
+        }
+    }
+    return row[text.size()];
+}
+
+void FuzzyIndex::deletionHashes(std::string_view name, std::size_t maxDeletions, std::vector<std::uint32_t>& hashes) {
+    static_assert(maxIndexedDistance <= 2, "deletionHashes generates at most two deletions");
+    hashes.clear();
+    char prefix[prefixLength];
+    const std::size_t length = std::min(name.size(), prefixLength);
+    CaseFold::toLower(name.data(), length, prefix);
+
+    auto hashWithout = [&prefix, length](std::size_t first, std::size_t second) { // FNV-1a of the prefix minus up to two positions
+        std::uint32_t hash = 2166136261u;
+        for (std::size_t i = 0; i < length; ++i) {
+            if (i != first && i != second) {
+                hash = (hash ^ static_cast<unsigned char>(prefix[i])) * 16777619u;
+            }
+        }
+        return hash;
+    };
+
+    hashes.push_back(hashWithout(length, length));
+    for (std::size_t first = 0; maxDeletions >= 1 && first < length; ++first) {
+        hashes.push_back(hashWithout(first, length));
+        for (std::size_t second = first + 1; maxDeletions >= 2 && second < length; ++second) {
+            hashes.push_back(hashWithout(first, second));
+        }
+    }
+    std::sort(hashes.begin(), hashes.end()); // Deleting either of two equal letters gives the same string
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+}
+
+void FuzzyIndex::clear() {
+    postings.clear();
+    postings.shrink_to_fit();
+    starts.assign(2, 0); // One empty bucket
+    pending.clear();
+    pending.shrink_to_fit();
+    external = nullptr;
+    externalSize = 0;
+    externalStarts = nullptr;
+    externalStartCount = 0;
+    externalOwner.reset();
+}
+
+void FuzzyIndex::rebucket(std::size_t bucketCount) { // A stable counting sort, so postings stay in entry order within each bucket
+    std::vector<std::uint32_t> counts(bucketCount + 1, 0);
+    for (const Posting& posting : postings) {
+        ++counts[bucketOf(posting.hash, bucketCount) + 1];
+    }
+    for (std::size_t b = 0; b < bucketCount; ++b) {
+        counts[b + 1] += counts[b];
+    }
+    starts = counts;
+
+    std::vector<Posting> grouped(postings.size());
+    for (const Posting& posting : postings) {
+        grouped[counts[bucketOf(posting.hash, bucketCount)]++] = posting;
+    }
+    postings.swap(grouped);
+}
+
+// - mergePending(): Appends the pending postings and regroups everything, doubling the bucket
+//   count while buckets would average more than eight postings.
+void FuzzyIndex::mergePending() {
+    if (pending.empty()) {
+        return;
+    }
+    detach();
+    postings.insert(postings.end(), pending.begin(), pending.end());
+    pending.clear();
+    std::size_t bucketCount = starts.size() - 1;
+    while (postings.size() > bucketCount * 8) {
+        bucketCount *= 2;
+    }
+    rebucket(bucketCount);
+}
+
+bool FuzzyIndex::attach(const Posting* table, std::size_t count, const std::uint32_t* bucketStart, std::size_t startCount,
+                        std::size_t entryCount, std::shared_ptr<const void> owner) {
+    const std::size_t bucketCount = startCount - 1;
+    if (startCount < 2 || (bucketCount & (bucketCount - 1)) != 0 || bucketStart[0] != 0 || bucketStart[bucketCount] != count) {
+        return false;
+    }
+    for (std::size_t b = 0; b < bucketCount; ++b) {
+        if (bucketStart[b] > bucketStart[b + 1]) {
+            return false;
+        }
+    }
+    for (std::size_t p = 0; p < count; ++p) {
+        if (table[p].entry >= entryCount) {
+            return false;
+        }
+    }
+
+    clear();
+    external = table;
+    externalSize = count;
+    externalStarts = bucketStart;
+    externalStartCount = startCount;
+    externalOwner = std::move(owner);
+    return true;
+}
+
+void FuzzyIndex::detach() {
+    if (external == nullptr) {
+        return;
+    }
+    postings.assign(external, external + externalSize);
+    starts.assign(externalStarts, externalStarts + externalStartCount);
+    external = nullptr;
+    externalSize = 0;
+    externalStarts = nullptr;
+    externalStartCount = 0;
+    externalOwner.reset();
+}
@@ -0,0 +1,200 @@
+// File: FuzzyIndex.h
+// Summary:
+// This file defines the FuzzyIndex class, a symmetric deletion index (as in SymSpell) over
+// the dictionary names, used for "did you mean" suggestions. Two words are within k edits
+// only if deleting at most k characters from each makes them equal, and that still holds
+// when only the first prefixLength characters of each are considered. So every word is
+// filed under the hashes of all its prefix deletions, a query generates the same deletions
+// of itself, and only the entries filed under one of them are compared in full.
+//
+// Input:
+// - build and insert take entry positions and a callable returning the name at a position.
+// - find takes the misspelled word, the largest edit distance to accept (at most
+//   maxIndexedDistance) and a result limit.
+//
+// Output:
+// - find returns matches ranked by edit distance (case is ignored), ties in dictionary order.
+//   Entries whose names repeat an earlier entry's name are left out, like the name index.
+// - The postings (deletion hash, entry) are grouped into hash buckets with one start array,
+//   which is what gets stored in snapshots. Like the other indexes they can be attached to
+//   a mapped snapshot and are copied into owned storage on the first insert.
+//
+// Comments:
+// - insert appends its postings to a short unsorted pending list, which find scans as well
+//   as the buckets. Once the list holds pendingLimit postings, or 1/pendingShare of the
+//   bucketed ones if that is more, it is merged into the buckets in one regrouping pass, so
+//   adding a word does not move the bucketed postings each time.
+//
+#ifndef FUZZYINDEX_H
+#define FUZZYINDEX_H
+
+#include "WordIndex.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class EditDistance { // Levenshtein distance from one fixed word, ignoring case.
+public:
+    explicit EditDistance(std::string_view pattern);
+    std::size_t to(std::string_view text) const; // The to function returns the distance from the pattern to text.
+
+private:
+    std::string_view pattern;
+    std::uint64_t matches[256]; // Bit i is set in matches[c] when lowercased pattern[i] is c (patterns up to 64 bytes)
+};
+
+class FuzzyIndex {
+public:
+    static constexpr std::size_t maxIndexedDistance = 2; // Deletions indexed per word, and so the largest distance find can answer
+    static constexpr std::size_t prefixLength = 7;       // Only deletions within the first prefixLength characters are indexed
+    static constexpr std::size_t pendingLimit = 4096;    // Fewest postings inserted before a regrouping; scanned by every find
+    static constexpr std::size_t pendingShare = 256;     // Regrouping waits for size() / pendingShare postings, so its cost per posting stays constant
+    static constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+
+    struct Posting {
+        std::uint32_t hash;  // Hash of one deletion of the name's prefix
+        std::uint32_t entry; // Dictionary position of the name
+    };
+
+    struct Match {
+        std::uint32_t entry;
+        std::uint32_t distance;
+    };
+
+    FuzzyIndex() { clear(); }
+
+    void clear(); // The clear function removes every posting.
+    bool attach(const Posting* table, std::size_t count, const std::uint32_t* starts, std::size_t startCount,
+                std::size_t entryCount, std::shared_ptr<const void> owner); // Uses mapped postings and bucket starts without copying them.
+    void detach(); // The detach function copies an attached index into owned storage.
+
+    std::size_t size() const { return external ? externalSize : postings.size(); }
+    const Posting* data() const { return external ? external : postings.data(); }
+    std::size_t bucketStartCount() const { return external ? externalStartCount : starts.size(); }
+    const std::uint32_t* bucketStarts() const { return external ? externalStarts : starts.data(); }
+    std::size_t pendingCount() const { return pending.size(); } // Postings not in the buckets (and so not in data()) yet
+    std::size_t memoryUsage() const { return (postings.capacity() + pending.capacity()) * sizeof(Posting) + starts.capacity() * sizeof(std::uint32_t); }
+    void mergePending(); // The mergePending function moves the pending postings into the buckets.
+
+    template <typename NameAt>
+    void build(std::size_t entryCount, NameAt nameAt); // The build function indexes entries 0 to entryCount - 1.
+
+    template <typename NameAt>
+    void insert(std::uint32_t entry, NameAt nameAt); // The insert function files one more entry.
+
+    template <typename NameAt>
+    std::vector<Match> find(std::string_view word, std::size_t maxDistance, std::size_t limit, NameAt nameAt) const; // Lists up to limit names within maxDistance of word.
+
+    static void deletionHashes(std::string_view name, std::size_t maxDeletions, std::vector<std::uint32_t>& hashes); // Sorted, distinct hashes of the prefix deletions.
+
+private:
+    static std::size_t bucketOf(std::uint32_t hash, std::size_t bucketCount) {
+        return static_cast<std::size_t>((static_cast<std::uint64_t>(hash) * bucketCount) >> 32);
+    }
+    void rebucket(std::size_t bucketCount); // Regroups every posting into bucketCount buckets
+
+    std::vector<Posting> postings;   // Grouped by bucket, in entry order within a bucket
+    std::vector<std::uint32_t> starts; // Bucket b holds postings [starts[b], starts[b + 1])
+    std::vector<Posting> pending;      // Inserted postings not grouped yet, in insertion order
+    const Posting* external = nullptr;
+    std::size_t externalSize = 0;
+    const std::uint32_t* externalStarts = nullptr;
+    std::size_t externalStartCount = 0;
+    std::shared_ptr<const void> externalOwner;
+};
+
+static_assert(sizeof(FuzzyIndex::Posting) == 8, "FuzzyIndex::Posting is stored in snapshots, its layout must not change");
+
+template <typename NameAt>
+void FuzzyIndex::build(std::size_t entryCount, NameAt nameAt) {
+    clear();
+    std::vector<std::uint32_t> hashes;
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        deletionHashes(nameAt(i), maxIndexedDistance, hashes);
+        for (std::uint32_t hash : hashes) {
+            postings.push_back(Posting{hash, static_cast<std::uint32_t>(i)});
+        }
+    }
+    std::size_t bucketCount = 1;
+    while (bucketCount * 4 < postings.size()) {
+        bucketCount *= 2;
+    }
+    rebucket(bucketCount);
+}
+
+template <typename NameAt>
+void FuzzyIndex::insert(std::uint32_t entry, NameAt nameAt) {
+    detach();
+    std::vector<std::uint32_t> hashes;
+    deletionHashes(nameAt(entry), maxIndexedDistance, hashes);
+    for (std::uint32_t hash : hashes) {
+        pending.push_back(Posting{hash, entry});
+    }
+    if (pending.size() >= std::max(pendingLimit, size() / pendingShare)) {
+        mergePending();
+    }
+}
+
+template <typename NameAt>
+std::vector<FuzzyIndex::Match> FuzzyIndex::find(std::string_view word, std::size_t maxDistance, std::size_t limit, NameAt nameAt) const {
+    std::vector<Match> found;
+    if ((size() == 0 && pending.empty()) || limit == 0) {
+        return found;
+    }
+    maxDistance = std::min(maxDistance, maxIndexedDistance);
+
+    std::vector<std::uint32_t> hashes;
+    deletionHashes(word, maxDistance, hashes);
+    std::vector<std::uint32_t> candidates;
+    const Posting* table = data();
+    const std::uint32_t* bucketStart = bucketStarts();
+    const std::size_t bucketCount = bucketStartCount() - 1;
+    for (std::uint32_t hash : hashes) {
+        const std::size_t bucket = bucketOf(hash, bucketCount);
+        for (std::uint32_t p = bucketStart[bucket]; p < bucketStart[bucket + 1]; ++p) {
+            if (table[p].hash == hash) {
+                candidates.push_back(table[p].entry);
+            }
+        }
+    }
+    for (const Posting& posting : pending) { // hashes is sorted
+        if (std::binary_search(hashes.begin(), hashes.end(), posting.hash)) {
+            candidates.push_back(posting.entry);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    const EditDistance fromWord(word);
+    for (std::uint32_t entry : candidates) { // Shared deletions only make a candidate, the full distance decides
+        const std::size_t distance = fromWord.to(nameAt(entry));
+        if (distance <= maxDistance) {
+            found.push_back(Match{entry, static_cast<std::uint32_t>(distance)});
+        }
+    }
+    std::stable_sort(found.begin(), found.end(), [](const Match& a, const Match& b) { return a.distance < b.distance; });
+
+    std::vector<Match> ranked;
+    for (const Match& match : found) {
+        bool repeated = false; // A repeated name sits at the same distance, after its first entry
+        for (auto earlier = ranked.rbegin(); earlier != ranked.rend() && earlier->distance == match.distance; ++earlier) {
+            if (WordIndex::equalsIgnoreCase(nameAt(match.entry), nameAt(earlier->entry))) {
+                repeated = true;
+                break;
+            }
+        }
+        if (!repeated) {
+            ranked.push_back(match);
+            if (ranked.size() == limit) {
+                break;
+            }
+        }
+    }
+    return ranked;
+}
+
+#endif // FUZZYINDEX_H
@@ -23,12 +23,17 @@
 //   word entries.
 //
 #include "ImprovedDictionary.h"
+#include "AtomicFile.h"
+#include "CaseFold.h"
+#include "DictionaryParser.h"
+#include "DictionaryWriter.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+#include "Tokenizer.h"
 #include <iostream>
-#include <cstdlib>
-#include <ctime>
-#include <sstream>
+#include <random>
 #include <algorithm>
-#include <fstream>
+#include <cctype>
 
 // - menu(): Displays a menu-driven interface for interacting with the dictionary. Options
 //   include choosing a file, searching for a word, listing palindromes, finding rhyming
@@ -75,6 +80,14 @@ void ImprovedDictionary::menu() {
                     std::cout << "Type: " << typeConversion(locatedWord.getType()) << "\n";
                 } else {
                     std::cout << "Word not found.\n";
+                    std::vector<FuzzyIndex::Match> suggestions = findSimilarWords(wordToSearch, defaultFuzzyDistance, maxSuggestions);
+                    if (!suggestions.empty()) {
+                        std::cout << "Did you mean: ";
+                        for (std::size_t i = 0; i < suggestions.size(); ++i) {
+                            std::cout << (i > 0 ? ", " : "") << nameAt(suggestions[i].entry);
+                        }
+                        std::cout << "?\n";
+                    }
                 }
                 break;
             }
@@ -122,31 +135,31 @@ void ImprovedDictionary::listPalindromesMenu() {
 
     switch (choice) {
         case '1':
-            listPalindromesRange('A');
+            listPalindromesRange('A', 'C');
             break;
         case '2':
-            listPalindromesRange('D');
+            listPalindromesRange('D', 'F');
             break;
         case '3':
-            listPalindromesRange('G');
+            listPalindromesRange('G', 'I');
             break;
         case '4':
-            listPalindromesRange('J');
+            listPalindromesRange('J', 'L');
             break;
         case '5':
-            listPalindromesRange('M');
+            listPalindromesRange('M', 'O');
             break;
         case '6':
-            listPalindromesRange('P');
+            listPalindromesRange('P', 'R');
             break;
         case '7':
-            listPalindromesRange('S');
+            listPalindromesRange('S', 'U');
             break;
         case '8':
-            listPalindromesRange('V');
+            listPalindromesRange('V', 'X');
             break;
         case '9':
-            std::cout << "No Palindromes Found\n";
+            listPalindromesRange('Y', 'Z');
             break;
         default:
             std::cout << "Invalid choice. Please try again.\n";
@@ -163,44 +176,68 @@ void ImprovedDictionary::rhymingWordsMenu() {
     std::string word;
     std::cin >> word;
 
-    std::vector<Word> rhymingWords = findRhymingWords(word);
+    std::vector<std::uint32_t> rhymingWords = findRhymingWords(word);
 
     if (rhymingWords.empty()) {
         std::cout << "No rhyming words found.\n";
     } else {
-        for (const auto& rhymingWord : rhymingWords) {
-            std::cout << rhymingWord.getName() << "\n";
+        for (std::uint32_t position : rhymingWords) {
+            std::cout << nameAt(position) << "\n";
         }
     }
 }
 
-// - findRhymingWords(const std::string& word): Finds and returns a vector of Word objects
-//   that rhyme with the provided word.
-std::vector<Word> ImprovedDictionary::findRhymingWords(const std::string& word) const {
-    std::vector<Word> rhymingWords;
+// - findRhymingWords(const std::string& word, std::size_t suffixLength): Finds the entries
+//   whose names end in the same suffixLength characters as word. The suffix index turns this
+//   into one range lookup; only the matching positions are copied out.
+std::vector<std::uint32_t> ImprovedDictionary::findRhymingWords(const std::string& word, std::size_t suffixLength) const {
+    Metrics::Timer timer(Metrics::Operation::Rhyme);
+    std::vector<std::uint32_t> rhymingWords;
 
-    // Ensure the word has at least 3 characters to find a rhyme
-    if (word.length() < 3) {
+    // Ensure the word has enough characters to find a rhyme
+    if (suffixLength == 0 || word.length() < suffixLength) {
         return rhymingWords;
     }
 
-    // Extract the last three characters of the word
-    std::string endSequence = word.substr(word.length() - 3);
-
-    // Check each word in the dictionary
-    for (const auto& dictWord : words) {
-        std::string dictEndSequence = dictWord.getName();
-        if (dictEndSequence.length() >= 3) {
-            dictEndSequence = dictEndSequence.substr(dictEndSequence.length() - 3);
-            if (endSequence == dictEndSequence) {
-                rhymingWords.push_back(dictWord);
-            }
-        }
-    }
+    // Look up every name ending in the last suffixLength characters of the word
+    std::string_view endSequence = std::string_view(word).substr(word.length() - suffixLength);
+    SuffixIndex::Range range = rhymeIndex.equalRange(endSequence, [this](std::uint32_t i) { return nameAt(i); });
 
+    // The index orders matches by reversed name, list them in dictionary order as before
+    rhymingWords.assign(range.first, range.second);
+    timer.scanned(rhymingWords.size());
+    std::sort(rhymingWords.begin(), rhymingWords.end());
     return rhymingWords;
 }
 
+// - findSimilarWords(std::string_view word, std::size_t maxDistance, std::size_t limit) const:
+//   Lists the entries whose names are at most maxDistance edits (insertions, deletions or
+//   substitutions, ignoring case) away from word, closest first.
+std::vector<FuzzyIndex::Match> ImprovedDictionary::findSimilarWords(std::string_view word, std::size_t maxDistance, std::size_t limit) const {
+    return fuzzyIndex.find(word, maxDistance, limit, [this](std::uint32_t i) { return nameAt(i); });
+}
+
+// - findWordsByDefinition(const std::vector<std::string_view>& terms, TermMatch match) const:
+//   Reverse dictionary lookup. Lists, in dictionary order, the entries whose definitions
+//   contain all (or any) of the terms, ignoring case and surrounding punctuation.
+std::vector<std::uint32_t> ImprovedDictionary::findWordsByDefinition(const std::vector<std::string_view>& terms, TermMatch match) const {
+    return definitionIndex.find(terms, match);
+}
+
+// - findWordsWithPrefix(std::string_view prefix, std::size_t limit) const: Lists the words
+//   starting with prefix (ignoring case) for autocomplete. The prefix index walks one trie
+//   node per character, so the cost does not depend on the size of the dictionary.
+std::vector<std::uint32_t> ImprovedDictionary::findWordsWithPrefix(std::string_view prefix, std::size_t limit) const {
+    return prefixIndex.find(prefix, limit, [this](std::uint32_t i) { return nameAt(i); });
+}
+
+// - pickClozeQuestion(std::uint64_t random, ClozeIndex::Question& question) const: Chooses a
+//   question for the guessing game. It only reads the prebuilt pool, so players on many
+//   threads can draw questions at once, each with a generator of its own.
+bool ImprovedDictionary::pickClozeQuestion(std::uint64_t random, ClozeIndex::Question& question) const {
+    return clozeIndex.pick(random, question);
+}
+
 // - playGuessTheFourthWord(): Implements a game where the user guesses the missing word
 //   from a definition, with scoring and high score tracking.
 void ImprovedDictionary::playGuessTheFourthWord() {
@@ -214,27 +251,20 @@ void ImprovedDictionary::playGuessTheFourthWord() {
     std::cout << "- The game ends when you guess incorrectly.\n";
     std::cout << "- Good luck!\n";
 
-    std::srand(std::time(nullptr));
+    std::mt19937_64 random(std::random_device{}());
+    ClozeIndex::Question question;
 
     while (true) {
-        Word randomWord;
-        do {
-            randomWord = words[rand() % words.size()];
-        } while (countWordsInDefinition(randomWord.getDefinition()) <= 4);
-
-        std::string definition = randomWord.getDefinition();
-        std::vector<std::string> wordsInDefinition = splitDefinitionIntoWords(definition);
-        int fourthWordIndex = 3; // Assuming the fourth word index is 3 (0-indexed)
-
-        std::string fourthWord = wordsInDefinition[fourthWordIndex];
-        wordsInDefinition[fourthWordIndex] = std::string(fourthWord.size(), '_');
-
-        std::cout << "\nWord: " << randomWord.getName() << "\n";
-        std::cout << "Definition: ";
-        for (const auto& word : wordsInDefinition) {
-            std::cout << word << " ";
+        if (!pickClozeQuestion(random(), question)) { // Also covers an empty dictionary
+            std::cout << "No definition in this dictionary has more than four words, so there is nothing to guess.\n";
+            return;
         }
-        std::cout << "\n";
+        const std::string_view definition = definitionAt(question.entry);
+        const std::string_view fourthWord = definition.substr(question.offset, question.length);
+
+        std::cout << "\nWord: " << nameAt(question.entry) << "\n";
+        std::cout << "Definition: " << definition.substr(0, question.offset) << std::string(fourthWord.size(), '_')
+                  << definition.substr(question.offset + question.length) << "\n";
 
         std::string guess;
         std::cout << "Guess the missing word: ";
@@ -256,79 +286,306 @@ void ImprovedDictionary::playGuessTheFourthWord() {
 }
 
 // - loadDictionaryFromFile(const std::string& filename): Loads a dictionary from a file
-//   into the program. This uses the function within the Dictionary.cpp file
+//   into the program. Compiled snapshots are mapped directly, text files use the function
+//   within the Dictionary.cpp file. The new entries and indexes are built in a separate
+//   dictionary and only replace these once the whole file has loaded, so a failed load
+//   leaves the current dictionary (and its journal) as it was.
 bool ImprovedDictionary::loadDictionaryFromFile(const std::string& filename) {
-    return loadFile(filename);
+    Metrics::Timer timer(Metrics::Operation::Load);
+    journal.waitForCompaction(); // Loading the same file again may finish a merge itself
+    const bool snapshot = DictionarySnapshot::isSnapshotFile(filename);
+
+    ImprovedDictionary loaded;
+    loaded.setStorageMode(storageMode);
+    loaded.setLoadThreads(loadThreads);
+    if (!(snapshot ? loaded.loadSnapshot(filename) : loaded.loadTextFile(filename))) {
+        return false;
+    }
+    loaded.highScore = highScore;
+    timer.scanned(loaded.wordCount());
+    timer.allocated(loaded.storageMemoryUsage());
+
+    journal.close();
+    *this = std::move(loaded);
+    if (!snapshot) {
+        journal.open(filename);
+    }
+    return true;
+}
+
+// - loadTextFile(const std::string& filename): Loads a text dictionary and the words in its journal.
+bool ImprovedDictionary::loadTextFile(const std::string& filename) {
+    std::string journalled;
+    Journal::recover(filename, journalled); // Before loadFile, so an interrupted compaction is finished first
+    if (!loadFile(filename)) {
+        return false;
+    }
+    replayJournal(journalled);
+    rebuildIndexes();
+    return true;
+}
+
+// - replayJournal(std::string_view records): Adds the journalled words in order. Words already in
+//   the dictionary are skipped, as addWordMenu never journals an existing word, so a journal
+//   that was merged into the file just before a crash is not applied twice.
+void ImprovedDictionary::replayJournal(std::string_view records) {
+    DictionaryParser::parse(records, [this](const RecordView& record) {
+        if (index.find(record.name, [this](std::uint32_t i) { return nameAt(i); }) == WordIndex::npos) {
+            appendEntry(record.name, record.type, record.definition, true);
+        }
+    });
+}
+
+// - rebuildIndexes(): Builds the suffix, palindrome, prefix, fuzzy, definition and cloze indexes over the entries that were just loaded.
+void ImprovedDictionary::rebuildIndexes() {
+    auto name = [this](std::size_t i) { return nameAt(i); };
+    rhymeIndex.build(wordCount(), name);
+    palindromeIndex.build(wordCount(), name);
+    prefixIndex.build(wordCount(), name);
+    fuzzyIndex.build(wordCount(), name);
+    definitionIndex.build(wordCount(), [this](std::size_t i) { return definitionAt(i); });
+    clozeIndex.build(wordCount(), [this](std::size_t i) { return definitionAt(i); });
+}
+
+// - insertWord(Word&& word): Moves a word into the dictionary and adds it to every index.
+//   Nothing is indexed if the storage cannot take the word.
+bool ImprovedDictionary::insertWord(Word&& word) {
+    if (!appendWord(std::move(word))) {
+        return false;
+    }
+    const auto position = static_cast<std::uint32_t>(wordCount() - 1);
+    rhymeIndex.insert(position, [this](std::uint32_t i) { return nameAt(i); });
+    palindromeIndex.insert(position, nameAt(position));
+    prefixIndex.insert(position, [this](std::uint32_t i) { return nameAt(i); });
+    fuzzyIndex.insert(position, [this](std::uint32_t i) { return nameAt(i); });
+    definitionIndex.insert(position, definitionAt(position));
+    clozeIndex.insert(position, definitionAt(position));
+    return true;
+}
+
+// - loadSnapshot(const std::string& filename): Maps a snapshot written by compileSnapshot and
+//   serves entries and lookups from it. Nothing is parsed or copied per entry.
+bool ImprovedDictionary::loadSnapshot(const std::string& filename) {
+    auto mapped = std::make_shared<DictionarySnapshot>();
+    if (!mapped->open(filename)) {
+        return false;
+    }
+
+    WordStore mappedStore; // Attached first, so the game questions can be checked against the definitions
+    if (!mappedStore.attachSections(*mapped, mapped)) {
+        std::cerr << "Snapshot has a corrupt word list: " << filename << "\n";
+        return false;
+    }
+    DictionarySnapshot::SectionData suffixes, palindromes;
+    SuffixIndex mappedSuffixes;
+    if (!mapped->section(DictionarySnapshot::Section::SuffixIndex, suffixes) || suffixes.count != mapped->size()
+        || suffixes.size != suffixes.count * sizeof(std::uint32_t)
+        || !mappedSuffixes.attach(static_cast<const std::uint32_t*>(suffixes.data), suffixes.count, mapped)) {
+        std::cerr << "Snapshot is missing its suffix index: " << filename << "\n";
+        return false;
+    }
+    PalindromeIndex mappedPalindromes;
+    if (!mapped->section(DictionarySnapshot::Section::PalindromeIndex, palindromes)
+        || palindromes.size != palindromes.count * sizeof(std::uint32_t)
+        || !mappedPalindromes.attach(static_cast<const std::uint32_t*>(palindromes.data), palindromes.count, mapped->size(), mapped)) {
+        std::cerr << "Snapshot is missing its palindrome index: " << filename << "\n";
+        return false;
+    }
+    DictionarySnapshot::SectionData prefixOrder, prefixNodes;
+    PrefixIndex mappedPrefixes;
+    if (!mapped->section(DictionarySnapshot::Section::PrefixOrder, prefixOrder)
+        || !mapped->section(DictionarySnapshot::Section::PrefixNodes, prefixNodes)
+        || prefixOrder.count != mapped->size() || prefixOrder.size != prefixOrder.count * sizeof(std::uint32_t)
+        || prefixNodes.size != prefixNodes.count * sizeof(PrefixIndex::Node)
+        || !mappedPrefixes.attach(static_cast<const std::uint32_t*>(prefixOrder.data), prefixOrder.count,
+                                  static_cast<const PrefixIndex::Node*>(prefixNodes.data), prefixNodes.count, mapped)) {
+        std::cerr << "Snapshot is missing its prefix index: " << filename << "\n";
+        return false;
+    }
+    DictionarySnapshot::SectionData fuzzyPostings, fuzzyBuckets;
+    FuzzyIndex mappedFuzzy;
+    if (!mapped->section(DictionarySnapshot::Section::FuzzyPostings, fuzzyPostings)
+        || !mapped->section(DictionarySnapshot::Section::FuzzyBuckets, fuzzyBuckets)
+        || fuzzyPostings.size != fuzzyPostings.count * sizeof(FuzzyIndex::Posting)
+        || fuzzyBuckets.size != fuzzyBuckets.count * sizeof(std::uint32_t)
+        || !mappedFuzzy.attach(static_cast<const FuzzyIndex::Posting*>(fuzzyPostings.data), fuzzyPostings.count,
+                               static_cast<const std::uint32_t*>(fuzzyBuckets.data), fuzzyBuckets.count, mapped->size(), mapped)) {
+        std::cerr << "Snapshot is missing its fuzzy index: " << filename << "\n";
+        return false;
+    }
+    DefinitionIndex mappedDefinitions;
+    if (!mappedDefinitions.attachSections(*mapped, mapped)) {
+        std::cerr << "Snapshot is missing its definition index: " << filename << "\n";
+        return false;
+    }
+    DictionarySnapshot::SectionData clozeQuestions;
+    ClozeIndex mappedCloze;
+    if (!mapped->section(DictionarySnapshot::Section::ClozeQuestions, clozeQuestions)
+        || clozeQuestions.size != clozeQuestions.count * sizeof(ClozeIndex::Question)
+        || !mappedCloze.attach(static_cast<const ClozeIndex::Question*>(clozeQuestions.data), clozeQuestions.count, mapped->size(),
+                               [&mappedStore](std::size_t entry) { return mappedStore.definitionSize(entry); }, mapped)) {
+        std::cerr << "Snapshot is missing its game questions: " << filename << "\n";
+        return false;
+    }
+    if (!adoptSnapshot(mapped, std::move(mappedStore))) {
+        std::cerr << "Snapshot has a corrupt name index: " << filename << "\n";
+        return false;
+    }
+    rhymeIndex = std::move(mappedSuffixes);
+    palindromeIndex = std::move(mappedPalindromes);
+    prefixIndex = std::move(mappedPrefixes);
+    fuzzyIndex = std::move(mappedFuzzy);
+    definitionIndex = std::move(mappedDefinitions);
+    clozeIndex = std::move(mappedCloze);
+    return true;
+}
+
+// - compileSnapshot(const std::string& filename) const: Writes the loaded dictionary as a
+//   snapshot: the WordStore columns and the name, suffix, palindrome, prefix, fuzzy, definition and cloze index tables.
+bool ImprovedDictionary::compileSnapshot(const std::string& filename) const {
+    DictionarySnapshot::Builder builder(wordCount());
+    if (compact) {
+        store.addSections(builder);
+    } else {
+        WordStore columns; // Snapshots always hold the column layout
+        for (const auto& word : words) {
+            if (!columns.append(word.getName(), word.getType(), word.getDefinition())) {
+                std::cout << "Too many distinct word types to compile a snapshot.\n";
+                return false;
+            }
+        }
+        columns.addSections(builder);
+    }
+    builder.addSection(DictionarySnapshot::Section::NameIndex, index.slotData(),
+                       index.slotCount() * sizeof(WordIndex::Slot), index.size());
+    builder.addSection(DictionarySnapshot::Section::SuffixIndex, rhymeIndex.data(),
+                       rhymeIndex.size() * sizeof(std::uint32_t), rhymeIndex.size());
+    builder.addSection(DictionarySnapshot::Section::PalindromeIndex, palindromeIndex.data(),
+                       palindromeIndex.tableSize() * sizeof(std::uint32_t), palindromeIndex.tableSize());
+    builder.addSection(DictionarySnapshot::Section::PrefixOrder, prefixIndex.data(),
+                       prefixIndex.size() * sizeof(std::uint32_t), prefixIndex.size());
+    builder.addSection(DictionarySnapshot::Section::PrefixNodes, prefixIndex.nodeData(),
+                       prefixIndex.nodeCount() * sizeof(PrefixIndex::Node), prefixIndex.nodeCount());
+    const FuzzyIndex* fuzzy = &fuzzyIndex;
+    FuzzyIndex merged;
+    if (fuzzyIndex.pendingCount() > 0) { // Snapshots hold bucketed postings only
+        merged = fuzzyIndex;
+        merged.mergePending();
+        fuzzy = &merged;
+    }
+    builder.addSection(DictionarySnapshot::Section::FuzzyPostings, fuzzy->data(),
+                       fuzzy->size() * sizeof(FuzzyIndex::Posting), fuzzy->size());
+    builder.addSection(DictionarySnapshot::Section::FuzzyBuckets, fuzzy->bucketStarts(),
+                       fuzzy->bucketStartCount() * sizeof(std::uint32_t), fuzzy->bucketStartCount());
+    definitionIndex.addSections(builder);
+    builder.addSection(DictionarySnapshot::Section::ClozeQuestions, clozeIndex.data(),
+                       clozeIndex.size() * sizeof(ClozeIndex::Question), clozeIndex.size());
+    return builder.write(filename);
 }
 
 // - searchWordInDictionary(const std::string& searchWord, Word& locatedWord) const: Searches
 //   for a word in the dictionary and returns its definition if found. This uses the function in the Dictionary.cpp file
 bool ImprovedDictionary::searchWordInDictionary(const std::string& searchWord, Word& locatedWord) const {
+    Metrics::Timer timer(Metrics::Operation::Search);
+    timer.scanned(1);
     return Dictionary::searchWord(searchWord, locatedWord);
 }
 
-// - isPalindrome(const std::string& word): Checks if a given word is a palindrome.
-bool ImprovedDictionary::isPalindrome(const std::string& word) {
-    std::string lowerWord = word;
-    std::transform(lowerWord.begin(), lowerWord.end(), lowerWord.begin(), ::tolower);
+// - searchWordsInDictionary(const std::vector<std::string_view>& queries) const: Looks up a whole
+//   batch of words. The queries are lowercased once into one buffer and hashed, repeated
+//   queries are looked up only once, and the distinct ones are shared out over the thread pool.
+std::vector<std::uint32_t> ImprovedDictionary::searchWordsInDictionary(const std::vector<std::string_view>& queries) const {
+    Metrics::Timer timer(Metrics::Operation::Search); // One call per batch
+    std::size_t totalLength = 0;
+    for (const auto query : queries) {
+        totalLength += query.size();
+    }
+    std::string lowered(totalLength, '\0');
+    std::vector<std::size_t> starts(queries.size() + 1, 0);
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        CaseFold::toLower(queries[q].data(), queries[q].size(), &lowered[starts[q]]);
+        starts[q + 1] = starts[q] + queries[q].size();
+    }
+    auto loweredQuery = [&lowered, &starts](std::size_t q) {
+        return std::string_view(lowered.data() + starts[q], starts[q + 1] - starts[q]);
+    };
+
+    // Give every distinct query a number, using a small open-addressing table of query numbers
+    std::vector<std::uint32_t> distinct;     // First query number of each distinct query
+    std::vector<std::uint32_t> hashes;       // hash of each distinct query
+    std::vector<std::uint32_t> distinctOf(queries.size());
+    std::size_t tableSize = 16;
+    while (tableSize < queries.size() * 2) {
+        tableSize *= 2;
+    }
+    std::vector<std::uint32_t> table(tableSize, WordIndex::npos);
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        const std::uint32_t h = WordIndex::hash(loweredQuery(q));
+        for (std::size_t i = h & (tableSize - 1);; i = (i + 1) & (tableSize - 1)) {
+            if (table[i] == WordIndex::npos) {
+                table[i] = static_cast<std::uint32_t>(distinct.size());
+                distinctOf[q] = table[i];
+                distinct.push_back(static_cast<std::uint32_t>(q));
+                hashes.push_back(h);
+                break;
+            }
+            if (hashes[table[i]] == h && loweredQuery(distinct[table[i]]) == loweredQuery(q)) {
+                distinctOf[q] = table[i];
+                break;
+            }
+        }
+    }
 
-    int i = 0, j = lowerWord.length() - 1;
-    while (i < j) {
-        if (lowerWord[i] != lowerWord[j]) {
-            return false;
+    timer.scanned(distinct.size());
+    std::vector<std::uint32_t> found(distinct.size());
+    auto lookUp = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t d = begin; d < end; ++d) {
+            found[d] = index.find(loweredQuery(distinct[d]), hashes[d], [this](std::uint32_t i) { return nameAt(i); });
         }
-        i++;
-        j--;
+    };
+    if (distinct.size() < minimumParallelBatch) {
+        lookUp(0, distinct.size()); // Handing out a small batch costs more than it saves
+    } else {
+        ThreadPool::shared().parallelFor(distinct.size(), lookUp);
     }
-    return true;
+
+    std::vector<std::uint32_t> results(queries.size());
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+        results[q] = found[distinctOf[q]];
+    }
+    return results;
+}
+
+// - isPalindrome(std::string_view word): Checks if a given word is a palindrome.
+bool ImprovedDictionary::isPalindrome(std::string_view word) const {
+    return PalindromeIndex::isPalindrome(word);
 }
-// - listPalindromesRange(char startLetter): Lists palindromes in the dictionary that start
-//   with a specified range of letters.
-void ImprovedDictionary::listPalindromesRange(char startLetter) {
+
+// - findPalindromes(char firstLetter, char lastLetter): Returns the positions of the palindromes
+//   whose first letter lies in the range, in dictionary order. Any range can be used, not only
+//   the sections offered by the menu.
+std::vector<std::uint32_t> ImprovedDictionary::findPalindromes(char firstLetter, char lastLetter) const {
+    Metrics::Timer timer(Metrics::Operation::Palindrome);
+    std::vector<std::uint32_t> palindromes = palindromeIndex.find(firstLetter, lastLetter);
+    timer.scanned(palindromes.size());
+    return palindromes;
+}
+
+// - listPalindromesRange(char firstLetter, char lastLetter): Lists palindromes in the dictionary
+//   that start with a letter in the range.
+void ImprovedDictionary::listPalindromesRange(char firstLetter, char lastLetter) const {
     std::cout << "\nPalindromes for range ";
 
-    switch (startLetter) {
-        case 'A':
-            std::cout << "A-C:\n";
-            break;
-        case 'D':
-            std::cout << "D-F:\n";
-            break;
-        case 'G':
-            std::cout << "G-I:\n";
-            break;
-        case 'J':
-            std::cout << "J-L:\n";
-            break;
-        case 'M':
-            std::cout << "M-O:\n";
-            break;
-        case 'P':
-            std::cout << "P-R:\n";
-            break;
-        case 'S':
-            std::cout << "S-U:\n";
-            break;
-        case 'V':
-            std::cout << "V-X:\n";
-            break;
-        case 'Y':
-            std::cout << "Y-Z:\n";
-            break;
-        default:
-            std::cout << "Unknown range\n";
-            return;
+    if (!std::isalpha(static_cast<unsigned char>(firstLetter)) || !std::isalpha(static_cast<unsigned char>(lastLetter))) {
+        std::cout << "Unknown range\n";
+        return;
     }
+    std::cout << firstLetter << "-" << lastLetter << ":\n";
 
     bool foundPalindrome = false;
-    for (const auto& word : words) {
-        char firstChar = std::toupper(word.getName()[0]);
-        if (firstChar >= startLetter && firstChar <= startLetter + 2) {
-            if (isPalindrome(word.getName())) {
-                std::cout << word.getName() << std::endl;
-                foundPalindrome = true;
-            }
-        }
+    for (std::uint32_t position : findPalindromes(firstLetter, lastLetter)) {
+        std::cout << nameAt(position) << std::endl;
+        foundPalindrome = true;
     }
 
     if (!foundPalindrome) {
@@ -365,14 +622,19 @@ void ImprovedDictionary::addWordMenu() {
     std::cout << "Enter the definition of the word (separate multiple definitions with ; ): ";
     std::getline(std::cin, definition);
 
-    Word newWord(name, type, definition);
-    words.push_back(newWord);
+    if (!insertWord(Word(std::move(name), std::move(type), std::move(definition)))) {
+        std::cout << "Error: Too many distinct word types to add this word.\n";
+        return;
+    }
 
     std::string filename;
     std::cout << "Enter the filename to save the dictionary: ";
     std::cin >> filename;
 
-    if (saveDictionaryToFile(filename)) {
+    // Saving back to the loaded file only appends the new word to its journal
+    const std::size_t added = wordCount() - 1;
+    const bool saved = filename == journal.dictionaryFile() && journal.append(nameAt(added), typeAt(added), definitionAt(added));
+    if (saved || saveDictionaryToFile(filename)) {
         std::cout << "Dictionary saved successfully.\n";
     } else {
         std::cout << "Failed to save dictionary.\n";
@@ -380,49 +642,43 @@ void ImprovedDictionary::addWordMenu() {
 }
 
 
-// - saveDictionaryToFile(const std::string& filename) const: Saves the current state of
-//   the dictionary to a file.
-bool ImprovedDictionary::saveDictionaryToFile(const std::string& filename) const {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        std::cout << "Error opening file: " << filename << "\n";
+// - addWord(Word word): Adds a word without any console interaction, for callers such as
+//   ConcurrentDictionary. Names are compared ignoring case, as in searchWordInDictionary.
+bool ImprovedDictionary::addWord(Word word) {
+    Metrics::Timer timer(Metrics::Operation::Add);
+    if (index.find(word.getName(), [this](std::uint32_t i) { return nameAt(i); }) != WordIndex::npos) {
         return false;
     }
-
-    for (const auto& word : words) {
-        file << "Type: " << word.getType() << "\n";
-        file << "Definition: " << word.getDefinition() << "\n";
-        file << "Word: " << word.getName() << "\n";
-        file << "\n";
+    // Counted from the entry itself: measuring storageMemoryUsage around the insert walks the whole dictionary
+    const std::size_t entryBytes = word.getName().size() + word.getType().size() + word.getDefinition().size();
+    if (!insertWord(std::move(word))) {
+        return false;
     }
-
-    file.close();
+    timer.scanned(1);
+    timer.allocated(entryBytes);
     return true;
 }
 
-
-// - countWordsInDefinition(const std::string& definition) const: Counts the number of words
-//   in a given definition string.
-int ImprovedDictionary::countWordsInDefinition(const std::string& definition) const {
-    int wordCount = 0;
-    std::string word;
-    std::istringstream stream(definition);
-    while (stream >> word) {
-        ++wordCount;
+// - saveDictionaryToFile(const std::string& filename) const: Saves the current state of
+//   the dictionary to a file. The text is written to a temporary file that replaces the
+//   old one only once it is complete and synced, so a crash never leaves half a dictionary.
+bool ImprovedDictionary::saveDictionaryToFile(const std::string& filename) const {
+    Metrics::Timer timer(Metrics::Operation::Save);
+    timer.scanned(wordCount());
+    if (filename == journal.dictionaryFile()) {
+        journal.waitForCompaction(); // A merge finishing later would replace the file written here
     }
-    return wordCount;
-}
-
-// - splitDefinitionIntoWords(const std::string& definition) const: Splits a definition string
-//   into individual words.
-std::vector<std::string> ImprovedDictionary::splitDefinitionIntoWords(const std::string& definition) const {
-    std::vector<std::string> words;
-    std::string word;
-    std::istringstream stream(definition);
-    while (stream >> word) {
-        words.push_back(word);
+    AtomicFile file(filename);
+    if (!file.open()) {
+        std::cout << "Error opening file: " << filename << "\n";
+        return false;
+    }
+    if (!DictionaryWriter::write(*this, file) || !file.commit()) {
+        std::cout << "Error writing file: " << filename << "\n";
+        return false;
+    }
+    if (filename == journal.dictionaryFile()) {
+        journal.reset(); // The file now holds every journalled word
     }
-    return words;
+    return true;
 }
-
-
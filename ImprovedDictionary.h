@@ -11,6 +11,10 @@
 // - The class takes input via user interaction in its menu methods to perform operations
 // - File names and word inputs are taken as string parameters for loading and saving
 //   dictionaries and for searching and adding words.
+// - searchWordsInDictionary takes a batch of query words, for example every token of a document.
+// - loadDictionaryFromFile accepts either a text dictionary or a snapshot written by
+//   compileSnapshot, which is mapped and used without parsing. Words added to a text
+//   dictionary are kept in its journal (see Journal.h), which is replayed here.
 //
 // Output:
 // - The class outputs information to the console after running the functions
@@ -19,26 +23,58 @@
 #ifndef IMPROVEDDICTIONARY_H
 #define IMPROVEDDICTIONARY_H
 
+#include "ClozeIndex.h"
+#include "DefinitionIndex.h"
 #include "Dictionary.h"
+#include "FuzzyIndex.h"
+#include "Journal.h"
+#include "PalindromeIndex.h"
+#include "PrefixIndex.h"
+#include "SuffixIndex.h"
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 
 class ImprovedDictionary : public Dictionary { // - The class inherits from the Dictionary class and extends its functionality.
 public:
+    static constexpr std::size_t defaultRhymeSuffixLength = 3; // - Words rhyme when their last defaultRhymeSuffixLength letters match.
+    static constexpr std::size_t defaultFuzzyDistance = 2; // - Suggestions may be up to this many edits away from the word searched for.
+    static constexpr std::size_t maxSuggestions = 5; // - The search menu suggests at most this many words when a search misses.
+    static constexpr std::size_t minimumParallelBatch = 4096; // - Batches with fewer distinct queries are looked up on the calling thread.
+
     void menu(); // - Menu-driven methods allow the user to select operations interactively.
     void listPalindromesMenu();  // - Various utility methods assist in performing operations such as listing palindromes, finding rhyming words, and counting words in definitions.
     void playGuessTheFourthWord();
     bool loadDictionaryFromFile(const std::string& filename);
     bool searchWordInDictionary(const std::string& searchWord, Word& locatedWord) const;
-    bool isPalindrome(const std::string& word);
+    std::vector<std::uint32_t> searchWordsInDictionary(const std::vector<std::string_view>& queries) const; // - searchWordsInDictionary returns the position of each query (WordIndex::npos if missing), in input order.
+    bool isPalindrome(std::string_view word) const;
+    std::vector<std::uint32_t> findPalindromes(char firstLetter, char lastLetter) const; // - findPalindromes returns the positions of palindromes starting with any letter in the range.
     void rhymingWordsMenu();
     void addWordMenu();
+    bool addWord(Word word); // - addWord adds a word that is not in the dictionary yet to the entries and every index; it returns false for an existing word or one the storage cannot take.
     bool saveDictionaryToFile(const std::string& filename) const;
+    bool compileSnapshot(const std::string& filename) const; // - compileSnapshot writes the loaded dictionary and its indexes as a binary snapshot.
+    std::vector<std::uint32_t> findRhymingWords(const std::string& word, std::size_t suffixLength = defaultRhymeSuffixLength) const; // - findRhymingWords returns the positions of rhyming entries, in dictionary order.
+    std::vector<FuzzyIndex::Match> findSimilarWords(std::string_view word, std::size_t maxDistance = defaultFuzzyDistance, std::size_t limit = FuzzyIndex::unlimited) const; // - findSimilarWords returns entries within maxDistance (at most 2) edits of word, closest first.
+    std::vector<std::uint32_t> findWordsByDefinition(const std::vector<std::string_view>& terms, TermMatch match = TermMatch::All) const; // - findWordsByDefinition returns the positions of entries whose definitions use the terms.
+    std::vector<std::uint32_t> findWordsWithPrefix(std::string_view prefix, std::size_t limit = PrefixIndex::unlimited) const; // - findWordsWithPrefix returns up to limit positions of names starting with prefix, alphabetically.
+    bool pickClozeQuestion(std::uint64_t random, ClozeIndex::Question& question) const; // - pickClozeQuestion chooses a game question from a random number; false if no definition is long enough.
 private:
-    void listPalindromesRange(char startLetter);
-    int countWordsInDefinition(const std::string& definition) const;
-    std::vector<std::string> splitDefinitionIntoWords(const std::string& definition) const;
-    std::vector<Word> findRhymingWords(const std::string& word) const; // Declaration for findRhymingWords
+    bool loadSnapshot(const std::string& filename);
+    bool loadTextFile(const std::string& filename);
+    bool insertWord(Word&& word); // - insertWord adds a word and updates every index, it is the only way words are added after loading; false if the storage cannot take it.
+    void rebuildIndexes(); // - rebuildIndexes builds the ImprovedDictionary indexes after a text file is loaded.
+    void replayJournal(std::string_view records); // - replayJournal adds the journalled words that the loaded file does not have yet.
+    void listPalindromesRange(char firstLetter, char lastLetter) const;
+    SuffixIndex rhymeIndex; // - Entry positions sorted by reversed name, so every rhyme is one contiguous range.
+    PalindromeIndex palindromeIndex; // - Palindrome positions bucketed by first letter, worked out once per entry.
+    DefinitionIndex definitionIndex; // - Definition terms to the entries using them, for reverse lookups.
+    FuzzyIndex fuzzyIndex; // - Deletion index over the names, for suggestions when a search misses.
+    PrefixIndex prefixIndex; // - Entry positions in alphabetical order with a trie of ranges over them, for autocomplete.
+    ClozeIndex clozeIndex; // - Entries whose definitions are long enough for the guessing game, with the word to hide in each.
+    mutable Journal journal; // - Words added since the loaded text file was last written; synchronised internally, and emptied when the whole dictionary is saved over that file.
     int highScore = 0; // - A member variable, highScore, tracks the user's performance in the word guessing game.
 };
 
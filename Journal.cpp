@@ -0,0 +1,321 @@
+// File: Journal.cpp
+// Summary:
+// This file implements the Journal class: recovering and reading the journal when a
+// dictionary is loaded, group committed appends, and the background merge into the
+// dictionary file. File access goes through descriptors (see AtomicFile) so each write
+// can be fsynced.
+//
+// Input:
+// - A dictionary file name and the fields of added entries.
+//
+// Output:
+// - "<file>.journal" with one record per added entry, and after a compaction a dictionary
+//   file that holds those records itself.
+//
+#include "Journal.h"
+#include "AtomicFile.h"
+#include "DictionaryParser.h"
+#include "MappedFile.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+bool fileExists(const std::string& path) {
+    return std::ifstream(path).is_open();
+}
+
+void appendRecord(std::string& out, std::string_view name, std::string_view type, std::string_view definition) {
+    out.append("Type: ").append(type).append("\nDefinition: ").append(definition);
+    out.append("\nWord: ").append(name).append("\n\n");
+}
+
+#ifdef _WIN32
+
+bool truncateFile(const std::string& path, std::size_t length) {
+    const int fd = _open(path.c_str(), _O_WRONLY | _O_BINARY);
+    if (fd < 0) {
+        return false;
+    }
+    const bool ok = _chsize_s(fd, static_cast<long long>(length)) == 0 && AtomicFile::syncFile(fd);
+    return AtomicFile::closeFile(fd) && ok;
+}
+
+#else
+
+bool truncateFile(const std::string& path, std::size_t length) {
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    const bool ok = ftruncate(fd, static_cast<off_t>(length)) == 0 && AtomicFile::syncFile(fd);
+    return AtomicFile::closeFile(fd) && ok;
+}
+
+#endif
+
+} // namespace
+
+// - completeLength(std::string_view records): Every record is written as "...\nWord: name\n\n" in
+//   one write, so a record is whole once the blank line after its "Word: " line is present.
+std::size_t Journal::completeLength(std::string_view records) {
+    std::size_t complete = 0;
+    std::size_t position = 0;
+    bool afterWordLine = false;
+    while (position < records.size()) {
+        const std::size_t newline = records.find('\n', position);
+        if (newline == std::string_view::npos) {
+            break; // An unterminated last line was cut short
+        }
+        std::string_view line = records.substr(position, newline - position);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty() && afterWordLine) {
+            complete = newline + 1;
+        }
+        afterWordLine = DictionaryParser::isWordLine(line);
+        position = newline + 1;
+    }
+    return complete;
+}
+
+void Journal::recover(const std::string& dictionaryFile, std::string& records) {
+    const std::string oldPath = dictionaryFile + ".journal.old";
+    const std::string path = dictionaryFile + ".journal";
+    records.clear();
+
+    // A compaction that was interrupted is finished first; if it cannot be, its records are replayed too
+    if (fileExists(oldPath) && !merge(dictionaryFile)) {
+        std::string old;
+        if (readFile(oldPath, old)) {
+            records.append(old, 0, completeLength(old));
+        }
+    }
+
+    std::string current;
+    if (readFile(path, current)) {
+        const std::size_t complete = completeLength(current);
+        if (complete < current.size() && !truncateFile(path, complete)) {
+            std::cerr << "Could not trim the incomplete record from journal: " << path << "\n";
+        }
+        records.append(current, 0, complete);
+    }
+}
+
+void Journal::open(const std::string& dictionaryFile) {
+    close();
+    basePath = dictionaryFile;
+    std::ifstream current(journalPath(), std::ios::binary | std::ios::ate);
+    journalBytes = current.is_open() ? static_cast<std::size_t>(current.tellg()) : 0;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (journalBytes >= compactionBytes) {
+        startCompaction(lock);
+    }
+}
+
+void Journal::close() {
+    waitForCompaction();
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return !flushing; });
+    if (compactor.joinable()) {
+        compactor.join();
+    }
+    if (file >= 0) {
+        AtomicFile::closeFile(file);
+    }
+    file = -1;
+    basePath.clear();
+    journalBytes = 0;
+    pending.clear();
+    queuedCount = durableCount = 0;
+    failed = false;
+}
+
+// - append(name, type, definition): Queues the record, then either writes the whole queue as
+//   the group's leader or waits for the thread that is already writing to reach this record.
+bool Journal::append(std::string_view name, std::string_view type, std::string_view definition) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (basePath.empty() || failed) {
+        return false;
+    }
+    appendRecord(pending, name, type, definition);
+    const std::uint64_t record = ++queuedCount;
+
+    while (durableCount < record && !failed) {
+        if (flushing) {
+            changed.wait(lock);
+        } else {
+            flushPending(lock);
+        }
+    }
+    if (durableCount < record) {
+        return false;
+    }
+    if (journalBytes >= compactionBytes) {
+        startCompaction(lock);
+    }
+    return true;
+}
+
+bool Journal::flushPending(std::unique_lock<std::mutex>& lock) {
+    flushing = true;
+    std::string batch;
+    batch.swap(pending);
+    const std::uint64_t lastRecord = queuedCount;
+    const bool created = file < 0;
+    if (created) {
+        file = AtomicFile::openForWriting(journalPath(), true);
+    }
+    const int fd = file;
+
+    lock.unlock(); // Other threads keep queueing records for the next group meanwhile
+    bool ok = fd >= 0 && AtomicFile::writeAll(fd, batch) && AtomicFile::syncFile(fd);
+    if (ok && created) {
+        AtomicFile::syncDirectory(journalPath());
+    }
+    lock.lock();
+
+    flushing = false;
+    if (ok) {
+        durableCount = lastRecord;
+        journalBytes += batch.size();
+    } else {
+        failed = true;
+        std::cerr << "Failed to write journal: " << journalPath() << "\n";
+    }
+    changed.notify_all();
+    return ok;
+}
+
+bool Journal::reset() {
+    waitForCompaction();
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return !flushing; });
+    if (file >= 0) {
+        AtomicFile::closeFile(file);
+        file = -1;
+    }
+    bool ok = true;
+    for (const std::string& path : {journalPath(), oldJournalPath()}) {
+        if (fileExists(path) && std::remove(path.c_str()) != 0) {
+            std::cerr << "Could not remove journal: " << path << "\n";
+            ok = false;
+        }
+    }
+    AtomicFile::syncDirectory(journalPath());
+    journalBytes = 0;
+    failed = !ok;
+    return ok;
+}
+
+void Journal::compact() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!basePath.empty()) {
+        startCompaction(lock);
+    }
+}
+
+void Journal::waitForCompaction() {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]() { return !compacting; });
+}
+
+// - startCompaction(lock): Moves the journal aside (unless an earlier merge left one there) and
+//   merges it on the compactor thread. New records go to a fresh journal in the meantime.
+void Journal::startCompaction(std::unique_lock<std::mutex>& lock) {
+    if (compacting) {
+        return;
+    }
+    changed.wait(lock, [this]() { return !flushing; });
+    if (compactor.joinable()) {
+        compactor.join(); // The last merge has finished, only its thread is left
+    }
+
+    if (!fileExists(oldJournalPath())) {
+        if (journalBytes == 0) {
+            return;
+        }
+        if (file >= 0) {
+            AtomicFile::closeFile(file);
+            file = -1;
+        }
+        if (std::rename(journalPath().c_str(), oldJournalPath().c_str()) != 0) {
+            std::cerr << "Could not move journal aside for compaction: " << journalPath() << "\n";
+            return;
+        }
+        AtomicFile::syncDirectory(journalPath());
+        journalBytes = 0;
+    }
+
+    compacting = true;
+    compactor = std::thread([this, path = basePath]() {
+        merge(path);
+        std::lock_guard<std::mutex> done(mutex);
+        compacting = false;
+        changed.notify_all();
+    });
+}
+
+bool Journal::merge(const std::string& dictionaryFile) {
+    const std::string oldPath = dictionaryFile + ".journal.old";
+    std::string old;
+    if (!readFile(oldPath, old)) {
+        return true;
+    }
+    old.resize(completeLength(old));
+
+    MappedFile mapped;
+    std::string copy;
+    std::string_view base;
+    if (mapped.open(dictionaryFile)) {
+        base = mapped.view();
+    } else if (readFile(dictionaryFile, copy)) { // Empty files cannot be mapped
+        base = copy;
+    } else {
+        std::cerr << "Could not read dictionary file for compaction: " << dictionaryFile << "\n";
+        return false;
+    }
+
+    // A file that already ends with the old journal was merged before the journal was removed
+    const bool merged = base.size() >= old.size() && base.substr(base.size() - old.size()) == old;
+    if (!merged) {
+        AtomicFile output(dictionaryFile, ".compact.tmp");
+        const bool separate = !base.empty() && base.back() != '\n';
+        const bool ok = output.open() && output.write(base) && (!separate || output.write("\n")) && output.write(old);
+        mapped.close(); // Windows cannot replace a file that is still mapped
+        if (!ok || !output.commit()) {
+            std::cerr << "Failed to merge journal into: " << dictionaryFile << "\n";
+            return false;
+        }
+    }
+
+    if (std::remove(oldPath.c_str()) != 0) {
+        std::cerr << "Could not remove merged journal: " << oldPath << "\n";
+        return false;
+    }
+    AtomicFile::syncDirectory(oldPath);
+    return true;
+}
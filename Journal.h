@@ -0,0 +1,93 @@
+// File: Journal.h
+// Summary:
+// This file defines the Journal class, an append-only log of the words added to a text
+// dictionary. Adding a word writes one record to "<file>.journal" instead of rewriting the
+// whole dictionary, so an insert costs the size of the entry. The journal is replayed on
+// top of the dictionary file when it is loaded, and once it grows past a threshold it is
+// merged into the dictionary file by a background thread.
+//
+// Input:
+// - recover and open take the dictionary file the journal belongs to.
+// - append takes the name, type and definition of one added entry.
+//
+// Output:
+// - recover fills records with every complete journalled entry, in the dictionary text
+//   format, so the caller can parse them with DictionaryParser. A record cut short by a
+//   crash is dropped and trimmed from the file. It is called before the dictionary file is
+//   read, and open attaches the journal for appending once the load has succeeded.
+// - append returns once the record is on disk (fsync). Threads appending at the same time
+//   share one write and one fsync: whichever thread finds no write in progress writes every
+//   record queued so far (group commit), the others wait for it.
+//
+// Comments:
+// - Records use the dictionary format, so merging is appending the journal to the file.
+//   Compaction renames the journal to "<file>.journal.old", starts a new one, writes the
+//   file plus the old journal to a temporary file, fsyncs it and renames it over the file.
+//   If that is interrupted, recover finishes it; a file that already ends with the old
+//   journal is not appended to twice.
+// - Errors are reported on std::cerr and through the return values, as in Dictionary.
+//
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+class Journal {
+public:
+    static constexpr std::size_t defaultCompactionBytes = std::size_t(1) << 20; // Journals this large are merged into the dictionary file.
+
+    Journal() = default;
+    ~Journal() { close(); }
+    Journal(const Journal&) : Journal() {} // Only one object may write a journal file, so copies start closed.
+    Journal& operator=(const Journal& other) {
+        if (this != &other) {
+            close();
+        }
+        return *this;
+    }
+
+    static void recover(const std::string& dictionaryFile, std::string& records); // The recover function reads the journal of dictionaryFile.
+    void open(const std::string& dictionaryFile); // The open function attaches the journal of dictionaryFile for appending.
+    void close(); // The close function waits for a running compaction and detaches the journal.
+    bool isOpen() const { return !basePath.empty(); }
+    const std::string& dictionaryFile() const { return basePath; }
+
+    bool append(std::string_view name, std::string_view type, std::string_view definition); // The append function makes one entry durable.
+    bool reset(); // The reset function empties the journal after the whole dictionary was saved over its file.
+    void compact(); // The compact function starts merging the journal into the dictionary file in the background.
+    void waitForCompaction(); // The waitForCompaction function returns once no compaction is running.
+    void setCompactionBytes(std::size_t bytes) { compactionBytes = bytes; }
+
+    static std::size_t completeLength(std::string_view records); // Length of the leading run of whole records (each ends "Word: ...\n\n").
+
+private:
+    std::string journalPath() const { return basePath + ".journal"; }
+    std::string oldJournalPath() const { return basePath + ".journal.old"; }
+    bool flushPending(std::unique_lock<std::mutex>& lock); // Writes and syncs the queued records, with the mutex released meanwhile.
+    void startCompaction(std::unique_lock<std::mutex>& lock);
+    static bool merge(const std::string& dictionaryFile); // Appends "<file>.journal.old" to the file and removes it.
+
+    std::string basePath;      // Dictionary file the journal belongs to, empty when closed
+    int file = -1;             // Journal descriptor, opened on the first append
+    std::size_t journalBytes = 0;
+    std::size_t compactionBytes = defaultCompactionBytes;
+
+    std::mutex mutex;
+    std::condition_variable changed; // Signalled when a group commit or a compaction finishes
+    std::string pending;             // Records queued for the next group commit
+    std::uint64_t queuedCount = 0;   // Records ever queued
+    std::uint64_t durableCount = 0;  // Records known to be on disk
+    bool flushing = false;           // A thread is writing a group right now
+    bool failed = false;             // A write failed, appends fail until the journal is reopened or reset
+    bool compacting = false;         // The compactor thread is merging
+
+    std::thread compactor;
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,263 @@
+// File: LzCodec.cpp
+// Summary:
+// This file implements the LzCodec class: the greedy compressor, the decompressor with its
+// bounds checks, and the dictionary trainer.
+//
+// Input:
+// - Text blocks, compressed blocks and sample text.
+//
+// Output:
+// - Compressed blocks, original bytes and shared dictionaries.
+//
+#include "LzCodec.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr unsigned hashBits = 14;
+constexpr std::size_t lastLiterals = 5; // Matches end this far before the block does, so every match search can read four bytes
+
+std::uint32_t read32(const char* p) {
+    std::uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+std::uint32_t hash4(const char* p) {
+    return (read32(p) * 2654435761u) >> (32 - hashBits);
+}
+
+void putLength(std::string& out, std::size_t length) { // The part of a length above 15
+    while (length >= 255) {
+        out.push_back(static_cast<char>(255));
+        length -= 255;
+    }
+    out.push_back(static_cast<char>(length));
+}
+
+void putSequence(std::string& out, const char* literals, std::size_t literalLength, std::size_t distance, std::size_t matchLength) {
+    const std::size_t matchCode = matchLength == 0 ? 0 : matchLength - LzCodec::minimumMatch;
+    out.push_back(static_cast<char>((std::min<std::size_t>(literalLength, 15) << 4) | std::min<std::size_t>(matchCode, 15)));
+    if (literalLength >= 15) {
+        putLength(out, literalLength - 15);
+    }
+    out.append(literals, literalLength);
+    if (matchLength == 0) {
+        return; // The closing sequence
+    }
+    out.push_back(static_cast<char>(distance & 0xFF));
+    out.push_back(static_cast<char>(distance >> 8));
+    if (matchCode >= 15) {
+        putLength(out, matchCode - 15);
+    }
+}
+
+bool getLength(const unsigned char*& in, const unsigned char* end, std::size_t& length) {
+    unsigned char byte;
+    do {
+        if (in == end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+} // namespace
+
+// - compress(input, dictionary, out): Works on the dictionary and the input laid out back to
+//   back, so a distance means the same thing whether it lands in the input or the dictionary.
+void LzCodec::compress(std::string_view input, std::string_view dictionary, std::string& out) {
+    if (dictionary.size() > maximumDistance) {
+        dictionary.remove_prefix(dictionary.size() - maximumDistance); // Older bytes are out of reach anyway
+    }
+    // The dictionary's table is built once per thread and copied for each block, which is far
+    // cheaper than hashing the dictionary again for every small block
+    thread_local std::string window;
+    thread_local std::vector<std::int32_t> primed;
+    thread_local std::vector<std::int32_t> table;
+    thread_local std::size_t primedSize = 0;
+    if (primed.empty() || primedSize != dictionary.size() || window.size() < dictionary.size() || window.compare(0, dictionary.size(), dictionary) != 0) {
+        window.assign(dictionary.data(), dictionary.size());
+        primed.assign(std::size_t(1) << hashBits, -1);
+        for (std::size_t i = 0; i + minimumMatch <= dictionary.size(); ++i) {
+            primed[hash4(window.data() + i)] = static_cast<std::int32_t>(i);
+        }
+        primedSize = dictionary.size();
+    }
+    window.resize(dictionary.size());
+    window.append(input.data(), input.size());
+    table = primed;
+
+    const char* base = window.data();
+    const std::size_t start = dictionary.size();
+    const std::size_t end = window.size();
+
+    std::size_t anchor = start;
+    if (input.size() > lastLiterals + minimumMatch) {
+        const std::size_t matchLimit = end - lastLiterals;
+        std::size_t i = start;
+        unsigned misses = 0;
+        while (i + minimumMatch <= matchLimit) {
+            const std::uint32_t slot = hash4(base + i);
+            const std::int32_t candidate = table[slot];
+            table[slot] = static_cast<std::int32_t>(i);
+            if (candidate < 0 || i - candidate > maximumDistance || read32(base + candidate) != read32(base + i)) {
+                i += 1 + (misses++ >> 5); // Skips ahead faster through text that does not compress
+                continue;
+            }
+            misses = 0;
+
+            std::size_t position = i;
+            std::size_t match = static_cast<std::size_t>(candidate);
+            while (position > anchor && match > 0 && base[position - 1] == base[match - 1]) {
+                --position;
+                --match;
+            }
+            std::size_t length = minimumMatch + (i - position);
+            while (position + length < matchLimit && base[match + length] == base[position + length]) {
+                ++length;
+            }
+            putSequence(out, base + anchor, position - anchor, position - match, length);
+            i = position + length;
+            anchor = i;
+            if (i >= 2 && i - 2 + minimumMatch <= end) {
+                table[hash4(base + i - 2)] = static_cast<std::int32_t>(i - 2);
+            }
+        }
+    }
+    putSequence(out, base + anchor, end - anchor, 0, 0);
+}
+
+bool LzCodec::decompress(const char* input, std::size_t inputSize, std::string_view dictionary, char* out, std::size_t outSize) {
+    const auto* in = reinterpret_cast<const unsigned char*>(input);
+    const unsigned char* const inEnd = in + inputSize;
+    char* op = out;
+    char* const outEnd = out + outSize;
+
+    while (in < inEnd) {
+        const unsigned token = *in++;
+        std::size_t literalLength = token >> 4;
+        if (literalLength == 15 && !getLength(in, inEnd, literalLength)) {
+            return false;
+        }
+        if (literalLength > static_cast<std::size_t>(inEnd - in) || literalLength > static_cast<std::size_t>(outEnd - op)) {
+            return false;
+        }
+        if (literalLength <= 16 && inEnd - in >= 16 && outEnd - op >= 16) {
+            std::memcpy(op, in, 16); // A fixed size copy of the usual short run, the excess is overwritten later
+        } else {
+            std::memcpy(op, in, literalLength);
+        }
+        op += literalLength;
+        in += literalLength;
+        if (in == inEnd) {
+            break; // The closing sequence has literals only
+        }
+
+        if (inEnd - in < 2) {
+            return false;
+        }
+        const std::size_t distance = in[0] | (std::size_t(in[1]) << 8);
+        in += 2;
+        std::size_t length = token & 15;
+        if (length == 15 && !getLength(in, inEnd, length)) {
+            return false;
+        }
+        length += minimumMatch;
+        const std::size_t produced = static_cast<std::size_t>(op - out);
+        if (distance == 0 || distance > produced + dictionary.size() || length > static_cast<std::size_t>(outEnd - op)) {
+            return false;
+        }
+
+        if (distance > produced) { // Starts in the dictionary, and may run on into the output
+            const std::size_t fromDictionary = std::min(distance - produced, length);
+            std::memcpy(op, dictionary.data() + dictionary.size() - (distance - produced), fromDictionary);
+            op += fromDictionary;
+            length -= fromDictionary;
+        }
+        const char* match = op - distance;
+        if (distance >= 8 && static_cast<std::size_t>(outEnd - op) >= length + 8) {
+            char* const end = op + length;
+            for (char* to = op; to < end; to += 8, match += 8) { // Eight bytes at a time, may write past the match
+                std::memcpy(to, match, 8);
+            }
+            op = end;
+        } else if (distance >= length) {
+            std::memcpy(op, match, length);
+            op += length;
+        } else {
+            while (length-- > 0) { // Overlapping copy repeats the last distance bytes
+                *op++ = *match++;
+            }
+        }
+    }
+    return op == outEnd;
+}
+
+// - train(sample, dictionaryBytes): Counts eight byte substrings of the sample, then
+//   repeatedly takes the segment whose substrings are most frequent and forgets the counts of
+//   the substrings it covers, so the dictionary does not hold the same phrase twice.
+std::string LzCodec::train(std::string_view sample, std::size_t dictionaryBytes) {
+    constexpr std::size_t substring = 8;
+    constexpr std::size_t segment = 64;
+    constexpr unsigned countBits = 20;
+    if (sample.size() < segment || dictionaryBytes < segment) {
+        return std::string();
+    }
+
+    std::vector<std::uint32_t> counts(std::size_t(1) << countBits, 0);
+    auto slotOf = [&](std::size_t position) {
+        std::uint64_t value;
+        std::memcpy(&value, sample.data() + position, sizeof(value));
+        return static_cast<std::size_t>((value * 0x9E3779B97F4A7C15ull) >> (64 - countBits));
+    };
+    for (std::size_t i = 0; i + substring <= sample.size(); ++i) {
+        ++counts[slotOf(i)];
+    }
+
+    const std::size_t segmentCount = sample.size() / segment;
+    auto scoreOf = [&](std::size_t s) {
+        std::uint64_t score = 0;
+        for (std::size_t i = s * segment; i + substring <= (s + 1) * segment; ++i) {
+            const std::uint32_t count = counts[slotOf(i)];
+            score += count > 1 ? count : 0; // A substring seen once helps nothing
+        }
+        return score;
+    };
+    std::priority_queue<std::pair<std::uint64_t, std::size_t>> best;
+    for (std::size_t s = 0; s < segmentCount; ++s) {
+        best.emplace(scoreOf(s), s);
+    }
+
+    // Scores only ever drop, so a segment whose fresh score still beats every stale one is the best
+    std::vector<std::size_t> chosen;
+    while ((chosen.size() + 1) * segment <= dictionaryBytes && !best.empty()) {
+        const std::size_t s = best.top().second;
+        best.pop();
+        const std::uint64_t score = scoreOf(s);
+        if (score == 0) {
+            break;
+        }
+        if (!best.empty() && score < best.top().first) {
+            best.emplace(score, s);
+            continue;
+        }
+        chosen.push_back(s);
+        for (std::size_t i = s * segment; i + substring <= (s + 1) * segment; ++i) {
+            counts[slotOf(i)] = 0;
+        }
+    }
+
+    std::string dictionary;
+    for (auto s = chosen.rbegin(); s != chosen.rend(); ++s) { // Best segments last, nearest to the data
+        dictionary.append(sample.data() + *s * segment, segment);
+    }
+    return dictionary;
+}
@@ -0,0 +1,47 @@
+// File: LzCodec.h
+// Summary:
+// This file defines the LzCodec class, a small LZ77 block compressor in the style of LZ4,
+// used to keep definition text compressed in memory. A block is a sequence of literal runs
+// and back references of at least four bytes within the last 64 KiB. Both directions can
+// be primed with a shared dictionary: text that is treated as if it came right before the
+// block, so short blocks can refer to common words and phrases they do not repeat
+// themselves. train builds such a dictionary from a sample of the text.
+//
+// Input:
+// - compress takes the block and the shared dictionary (possibly empty).
+// - decompress takes a compressed block, the same dictionary and the block's original size.
+// - train takes sample text and the size of the dictionary to build.
+//
+// Output:
+// - compress appends the compressed block to a string; decompress writes exactly the
+//   original bytes and returns False if the input is not a valid block for that size.
+//
+// Comments:
+// - The format is one token byte per sequence (literal length in the high four bits, match
+//   length minus four in the low four bits, each continued with 255-valued bytes when it
+//   is 15), the literals, and a two byte little-endian distance. The last sequence has
+//   literals only. Distances may reach back into the dictionary.
+// - The compressor is greedy with one hash table slot per four byte prefix, which trades
+//   some ratio for speed; decompression is a loop of memcpys and runs at memory speed.
+// - train is a simplified version of the segment selection in zstd's COVER trainer: it
+//   scores fixed size segments of the sample by how frequent their eight byte substrings
+//   are, takes the best ones, and stops counting substrings already covered.
+//
+#ifndef LZCODEC_H
+#define LZCODEC_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+class LzCodec {
+public:
+    static constexpr std::size_t minimumMatch = 4;
+    static constexpr std::size_t maximumDistance = 65535;
+
+    static void compress(std::string_view input, std::string_view dictionary, std::string& out); // Appends the compressed input to out.
+    static bool decompress(const char* input, std::size_t inputSize, std::string_view dictionary, char* out, std::size_t outSize);
+    static std::string train(std::string_view sample, std::size_t dictionaryBytes); // Builds a shared dictionary of at most dictionaryBytes.
+};
+
+#endif // LZCODEC_H
@@ -0,0 +1,142 @@
+// File: MappedFile.cpp
+// Summary:
+// This file implements the MappedFile class using mmap on POSIX systems and
+// CreateFileMapping/MapViewOfFile on Windows.
+//
+// Input:
+// - A file name; only non-empty regular files are mapped.
+//
+// Output:
+// - A read-only view of the file contents.
+//
+// Comments:
+// - The view is not a snapshot. MAP_PRIVATE only keeps this process's own writes private;
+//   since the view is never written, every page shows the file's current contents, so a
+//   file rewritten in place changes under its readers, and one truncated in place makes
+//   reading the lost pages raise SIGBUS. Files that are mapped must be replaced by rename
+//   (see FileWatcher.h).
+// - Failing to map is not treated as an error here and nothing is printed, the loaders
+//   report errors themselves after trying their stream based fallback.
+//
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        mappedData = std::exchange(other.mappedData, nullptr);
+        mappedSize = std::exchange(other.mappedSize, 0);
+#ifdef _WIN32
+        mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& filename, Access access) {
+    close();
+
+    const DWORD hint = access == Access::Sequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS;
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | hint, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file); // The mapping keeps its own reference to the file
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    mappedData = static_cast<const char*>(view);
+    mappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+    mappingHandle = mapping;
+    return true;
+}
+
+void MappedFile::close() {
+    if (mappedData != nullptr) {
+        UnmapViewOfFile(mappedData);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+    }
+    mappedData = nullptr;
+    mappedSize = 0;
+    mappingHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string& filename, Access access) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping stays valid after the descriptor is closed
+    if (view == MAP_FAILED) {
+        return false;
+    }
+
+#if defined(MADV_SEQUENTIAL) && defined(MADV_RANDOM)
+    // Parsers read front to back, so the kernel may read ahead and drop what is behind them.
+    // Mapped snapshots are looked up anywhere for as long as they are served, and sequential
+    // advice would evict the pages those lookups keep returning to.
+    madvise(view, static_cast<std::size_t>(info.st_size), access == Access::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+#else
+    (void)access;
+#endif
+
+    mappedData = static_cast<const char*>(view);
+    mappedSize = static_cast<std::size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (mappedData != nullptr) {
+        munmap(const_cast<char*>(mappedData), mappedSize);
+    }
+    mappedData = nullptr;
+    mappedSize = 0;
+}
+
+#endif
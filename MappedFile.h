@@ -0,0 +1,58 @@
+// File: MappedFile.h
+// Summary:
+// This file defines the MappedFile class, a small owner of a read-only memory mapping of
+// a whole file. The dictionary loaders use it to scan a file in place instead of reading
+// it line by line through a stream.
+//
+// Input:
+// - The open function takes the name of the file to map and how it will be read: Sequential
+//   for files parsed front to back (the kernel reads ahead and drops pages behind the
+//   reader), Random for files read at scattered offsets for as long as they are open, such
+//   as snapshots (no read ahead, pages stay cached).
+//
+// Output:
+// - open returns True if the file was mapped, or False if it could not be (missing file,
+//   empty file, pipe or other non-regular file, or a platform without mapping support).
+//   Callers are expected to fall back to stream reading when it returns False.
+// - data, size and view expose the mapped bytes until close is called or the object is
+//   destroyed.
+//
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+class MappedFile {
+public:
+    enum class Access {
+        Sequential, // One pass from front to back, such as parsing a text dictionary
+        Random,     // Lookups anywhere in the file for the whole time it is mapped
+    };
+
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& filename, Access access = Access::Sequential); // The open function maps the whole file read-only.
+    void close(); // The close function unmaps the file, it is safe to call more than once.
+
+    bool isOpen() const { return mappedData != nullptr; }
+    const char* data() const { return mappedData; }
+    std::size_t size() const { return mappedSize; }
+    std::string_view view() const { return std::string_view(mappedData, mappedSize); }
+
+private:
+    const char* mappedData = nullptr;
+    std::size_t mappedSize = 0;
+#ifdef _WIN32
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_H
@@ -0,0 +1,384 @@
+// File: Metrics.cpp
+// Summary:
+// This file implements the Metrics class: the per-thread counter blocks and their merging,
+// the log-linear latency buckets, the Prometheus text export and the dump on a signal.
+//
+// Input:
+// - Calls, latencies and counts recorded by Metrics::Timer on any thread.
+//
+// Output:
+// - Merged totals and their Prometheus text rendering, written to a descriptor or a file.
+//
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char* const operationNames[Metrics::operationCount] = {"load", "search", "rhyme", "palindrome", "add", "save"};
+
+// Upper bounds of the exported histogram buckets, in seconds; the full resolution stays in the quantiles
+const double exportedBounds[] = {1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4, 2.5e-4, 5e-4,
+                                 1e-3, 2.5e-3, 5e-3, 1e-2, 2.5e-2, 5e-2, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+const double exportedQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+struct Counters {
+    std::atomic<std::uint64_t> calls;
+    std::atomic<std::uint64_t> nanoseconds;
+    std::atomic<std::uint64_t> scanned;
+    std::atomic<std::uint64_t> allocatedBytes;
+    std::atomic<std::uint64_t> buckets[Metrics::bucketCount];
+};
+
+struct ThreadBlock {
+    Counters operations[Metrics::operationCount];
+};
+
+// Only the owning thread writes a block, so a relaxed load and store is enough and cheaper than fetch_add
+void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+void addInto(Metrics::Totals& totals, const ThreadBlock& block) {
+    for (std::size_t op = 0; op < Metrics::operationCount; ++op) {
+        const Counters& counters = block.operations[op];
+        Metrics::OperationTotals& total = totals[op];
+        total.calls += counters.calls.load(std::memory_order_relaxed);
+        total.nanoseconds += counters.nanoseconds.load(std::memory_order_relaxed);
+        total.scanned += counters.scanned.load(std::memory_order_relaxed);
+        total.allocatedBytes += counters.allocatedBytes.load(std::memory_order_relaxed);
+        for (std::size_t b = 0; b < Metrics::bucketCount; ++b) {
+            total.buckets[b] += counters.buckets[b].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadBlock*> live;
+    Metrics::Totals retired{}; // Counts of threads that have exited
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry(); // Never destroyed, threads may still exit during shutdown
+    return *instance;
+}
+
+struct BlockOwner {
+    ThreadBlock* block = nullptr;
+
+    ~BlockOwner() {
+        if (block != nullptr) {
+            Registry& shared = registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            addInto(shared.retired, *block);
+            shared.live.erase(std::find(shared.live.begin(), shared.live.end(), block));
+            delete block;
+        }
+    }
+};
+
+ThreadBlock& localBlock() {
+    thread_local BlockOwner owner;
+    if (owner.block == nullptr) {
+        owner.block = new ThreadBlock(); // Value-initialised, so every counter starts at zero
+        Registry& shared = registry();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.live.push_back(owner.block);
+    }
+    return *owner.block;
+}
+
+unsigned highestBit(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+} // namespace
+
+std::size_t Metrics::bucketOf(std::uint64_t nanoseconds) {
+    if (nanoseconds < subBuckets) {
+        return static_cast<std::size_t>(nanoseconds);
+    }
+    const unsigned exponent = highestBit(nanoseconds); // At least 3
+    return (exponent - 2) * subBuckets + ((nanoseconds >> (exponent - 3)) & (subBuckets - 1));
+}
+
+std::uint64_t Metrics::bucketLimit(std::size_t bucket) {
+    if (bucket < subBuckets) {
+        return bucket;
+    }
+    const unsigned exponent = static_cast<unsigned>(bucket / subBuckets) + 2;
+    const std::uint64_t width = std::uint64_t(1) << (exponent - 3);
+    return (subBuckets + bucket % subBuckets) * width + (width - 1);
+}
+
+std::uint64_t Metrics::OperationTotals::bucketTotal() const {
+    std::uint64_t total = 0;
+    for (std::uint64_t count : buckets) {
+        total += count;
+    }
+    return total;
+}
+
+double Metrics::OperationTotals::quantileSeconds(double fraction) const {
+    const std::uint64_t total = bucketTotal();
+    if (total == 0) {
+        return 0.0;
+    }
+    const std::uint64_t wanted = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(fraction * total + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < bucketCount; ++b) {
+        seen += buckets[b];
+        if (seen >= wanted) {
+            return bucketLimit(b) / 1e9;
+        }
+    }
+    return bucketLimit(bucketCount - 1) / 1e9;
+}
+
+void Metrics::record(Operation operation, bool timed, std::uint64_t nanoseconds, std::uint64_t scanned, std::uint64_t allocatedBytes) {
+    Counters& counters = localBlock().operations[static_cast<std::size_t>(operation)];
+    bump(counters.calls, 1);
+    bump(counters.scanned, scanned);
+    bump(counters.allocatedBytes, allocatedBytes);
+    if (timed) {
+        bump(counters.nanoseconds, nanoseconds);
+        bump(counters.buckets[bucketOf(nanoseconds)], 1);
+    }
+}
+
+Metrics::Totals Metrics::snapshot() {
+    Registry& shared = registry();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+    Totals totals = shared.retired;
+    for (const ThreadBlock* block : shared.live) {
+        addInto(totals, *block);
+    }
+    return totals;
+}
+
+std::string Metrics::prometheusText() {
+    std::ostringstream out;
+    if (!compiledIn) {
+        out << "# Dictionary metrics were compiled out (DICTIONARY_NO_METRICS).\n";
+        return out.str();
+    }
+    const Totals totals = snapshot();
+    auto label = [](std::size_t op) { return std::string("{operation=\"") + operationNames[op] + "\""; };
+
+    out << "# HELP dictionary_metrics_enabled Whether dictionary operations are being recorded.\n"
+        << "# TYPE dictionary_metrics_enabled gauge\n"
+        << "dictionary_metrics_enabled " << (enabled() ? 1 : 0) << "\n";
+
+    out << "# HELP dictionary_operations_total Calls of each dictionary operation.\n"
+        << "# TYPE dictionary_operations_total counter\n";
+    for (std::size_t op = 0; op < operationCount; ++op) {
+        out << "dictionary_operations_total" << label(op) << "} " << totals[op].calls << "\n";
+    }
+
+    out << "# HELP dictionary_operation_duration_seconds Time taken by each dictionary operation (searches are sampled).\n"
+        << "# TYPE dictionary_operation_duration_seconds histogram\n";
+    for (std::size_t op = 0; op < operationCount; ++op) {
+        const OperationTotals& total = totals[op];
+        const std::uint64_t count = total.bucketTotal(); // The timed calls
+        std::uint64_t cumulative = 0;
+        std::size_t b = 0;
+        for (double bound : exportedBounds) {
+            const std::uint64_t boundNanoseconds = static_cast<std::uint64_t>(bound * 1e9 + 0.5);
+            for (; b < bucketCount && bucketLimit(b) <= boundNanoseconds; ++b) {
+                cumulative += total.buckets[b];
+            }
+            out << "dictionary_operation_duration_seconds_bucket" << label(op) << ",le=\"" << bound << "\"} " << cumulative << "\n";
+        }
+        out << "dictionary_operation_duration_seconds_bucket" << label(op) << ",le=\"+Inf\"} " << count << "\n"
+            << "dictionary_operation_duration_seconds_sum" << label(op) << "} " << total.nanoseconds / 1e9 << "\n"
+            << "dictionary_operation_duration_seconds_count" << label(op) << "} " << count << "\n";
+    }
+
+    out << "# HELP dictionary_operation_duration_quantile_seconds Latency quantiles from the full resolution histogram.\n"
+        << "# TYPE dictionary_operation_duration_quantile_seconds gauge\n";
+    for (std::size_t op = 0; op < operationCount; ++op) {
+        for (double quantile : exportedQuantiles) {
+            out << "dictionary_operation_duration_quantile_seconds" << label(op) << ",quantile=\"" << quantile << "\"} "
+                << totals[op].quantileSeconds(quantile) << "\n";
+        }
+    }
+
+    out << "# HELP dictionary_entries_scanned_total Entries gone through by each operation.\n"
+        << "# TYPE dictionary_entries_scanned_total counter\n";
+    for (std::size_t op = 0; op < operationCount; ++op) {
+        out << "dictionary_entries_scanned_total" << label(op) << "} " << totals[op].scanned << "\n";
+    }
+    out << "# HELP dictionary_allocated_bytes_total Bytes of entry storage built by each operation.\n"
+        << "# TYPE dictionary_allocated_bytes_total counter\n";
+    for (std::size_t op = 0; op < operationCount; ++op) {
+        out << "dictionary_allocated_bytes_total" << label(op) << "} " << totals[op].allocatedBytes << "\n";
+    }
+    return out.str();
+}
+
+bool Metrics::writePrometheus(int fd) {
+    const std::string text = prometheusText();
+    std::size_t written = 0;
+    while (written < text.size()) {
+#ifdef _WIN32
+        const int count = _write(fd, text.data() + written, static_cast<unsigned>(text.size() - written));
+#else
+        const ssize_t count = ::write(fd, text.data() + written, text.size() - written);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (count <= 0) {
+            return false;
+        }
+        written += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+// - writePrometheusFile(const std::string& filename): Writes a temporary file beside filename
+//   and renames it over filename, so a collector reading the file sees the old or the new
+//   metrics, never a mix.
+bool Metrics::writePrometheusFile(const std::string& filename) {
+    const std::string temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file << prometheusText();
+        file.close();
+        if (file.fail()) {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+#ifdef _WIN32
+    std::remove(filename.c_str()); // rename does not replace an existing file on Windows
+#endif
+    return std::rename(temporary.c_str(), filename.c_str()) == 0;
+}
+
+#ifdef _WIN32
+
+bool Metrics::dumpOnSignal(int, const std::string&) {
+    return false;
+}
+
+void Metrics::stopDumping() {}
+
+#else
+
+namespace {
+
+struct Dumper {
+    std::mutex mutex;
+    std::thread thread;
+    int signal = 0;
+    struct sigaction previous {};
+};
+
+Dumper& dumper() {
+    static Dumper* instance = new Dumper();
+    return *instance;
+}
+
+volatile sig_atomic_t dumpPipe = -1; // Write end, used by the signal handler
+
+extern "C" void requestDump(int) {
+    const int savedErrno = errno;
+    const char dump = 'd';
+    if (dumpPipe >= 0) {
+        const ssize_t written = write(dumpPipe, &dump, 1); // Dropped if the pipe is full; a dump is pending anyway
+        (void)written;
+    }
+    errno = savedErrno;
+}
+
+} // namespace
+
+// - dumpOnSignal(int signal, const std::string& filename): Installs a handler that only writes
+//   a byte to a pipe, since building the text is not safe inside a signal handler. A thread
+//   waiting on the pipe writes the file.
+bool Metrics::dumpOnSignal(int signal, const std::string& filename) {
+    stopDumping();
+    Dumper& state = dumper();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFL, O_NONBLOCK);
+    dumpPipe = fds[1];
+
+    struct sigaction action {};
+    action.sa_handler = requestDump;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    if (sigaction(signal, &action, &state.previous) != 0) {
+        dumpPipe = -1;
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    state.signal = signal;
+    state.thread = std::thread([readFd = fds[0], writeFd = fds[1], filename]() {
+        char request;
+        ssize_t got;
+        while ((got = read(readFd, &request, 1)) != 0) {
+            if (got < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            if (request == 'q') {
+                break;
+            }
+            writePrometheusFile(filename);
+        }
+        close(readFd);
+        close(writeFd);
+    });
+    return true;
+}
+
+void Metrics::stopDumping() {
+    Dumper& state = dumper();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (!state.thread.joinable()) {
+        return;
+    }
+    sigaction(state.signal, &state.previous, nullptr);
+    const int writeFd = dumpPipe;
+    dumpPipe = -1;
+    const char quit = 'q';
+    while (write(writeFd, &quit, 1) < 0 && (errno == EINTR || errno == EAGAIN)) {
+        std::this_thread::yield(); // The pipe is full of dump requests the thread is still reading
+    }
+    state.thread.join();
+}
+
+#endif
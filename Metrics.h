@@ -0,0 +1,130 @@
+// File: Metrics.h
+// Summary:
+// This file defines the Metrics class, the instrumentation of ImprovedDictionary's hot
+// paths. For each operation (load, search, rhyme, palindrome, add and save) it counts the
+// calls, keeps a latency histogram, and counts the entries the calls went through and the
+// bytes of entry storage they allocated. The totals can be exported in the Prometheus text
+// format.
+//
+// Input:
+// - Timers placed in the instrumented functions, and enable to switch recording on.
+//
+// Output:
+// - snapshot returns the merged totals; prometheusText renders them. writePrometheus writes
+//   them to a file descriptor (a file, pipe or socket) and writePrometheusFile to a file,
+//   replacing it atomically so a scraper never reads half of it. dumpOnSignal rewrites a
+//   file whenever the process receives a signal, for example SIGUSR1.
+//
+// Comments:
+// - Recording is off until enable(true) is called; a disabled timer costs one relaxed load
+//   of a global flag. Building with -DDICTIONARY_NO_METRICS removes the timers altogether,
+//   and the export then reports that metrics were compiled out.
+// - Every thread records into its own block of counters, so recording takes no lock and
+//   shares no cache line with other threads. The blocks are only added up when the metrics
+//   are read. A thread's counts are folded into a shared total when the thread exits.
+// - Histograms are log-linear like HdrHistogram: eight buckets for every power of two of
+//   nanoseconds, so any latency from 1 ns to hours is kept to within 12.5%.
+// - Searches take a few hundred nanoseconds, mostly waiting on memory, and reading the clock
+//   stops the processor from overlapping one search's cache misses with the next one's,
+//   which made timing every search double its cost. Only one search in searchSampleEvery
+//   per thread is timed; every call is still counted. The other operations are timed on
+//   every call.
+// - "Entries scanned" is what each operation goes through: the entries loaded or saved,
+//   the words a search (or each distinct word of a batch search) looks up, and the matches
+//   a rhyme or palindrome query collects. A batch search counts as one call. "Bytes
+//   allocated" is the entry storage built by loads (see Dictionary::storageMemoryUsage)
+//   and the text of added entries, not every heap allocation.
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class Metrics {
+public:
+    enum class Operation { Load, Search, Rhyme, Palindrome, Add, Save };
+    static constexpr std::size_t operationCount = 6;
+    static constexpr std::size_t subBuckets = 8;             // Buckets per power of two
+    static constexpr std::size_t bucketCount = 62 * subBuckets; // Enough for any 64-bit number of nanoseconds
+    static constexpr unsigned searchSampleEvery = 16;
+
+#ifdef DICTIONARY_NO_METRICS
+    static constexpr bool compiledIn = false;
+#else
+    static constexpr bool compiledIn = true;
+#endif
+
+    struct OperationTotals {
+        std::uint64_t calls = 0;
+        std::uint64_t nanoseconds = 0;
+        std::uint64_t scanned = 0;
+        std::uint64_t allocatedBytes = 0;
+        std::array<std::uint64_t, bucketCount> buckets{};
+
+        std::uint64_t bucketTotal() const; // Calls that were timed.
+        double quantileSeconds(double fraction) const; // Upper edge of the bucket holding that fraction of calls.
+    };
+    using Totals = std::array<OperationTotals, operationCount>;
+
+    // Times one call from construction to destruction, if recording was on when it started
+    class Timer {
+    public:
+#ifdef DICTIONARY_NO_METRICS
+        explicit Timer(Operation) {}
+        void scanned(std::uint64_t) {}
+        void allocated(std::uint64_t) {}
+#else
+        explicit Timer(Operation operation)
+            : operation(operation), active(enabled()),
+              timed(active && (operation != Operation::Search || ++searchCalls % searchSampleEvery == 0)) {
+            if (timed) {
+                start = std::chrono::steady_clock::now();
+            }
+        }
+        ~Timer() {
+            if (active) {
+                const std::uint64_t nanoseconds = timed ? static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                              std::chrono::steady_clock::now() - start).count()) : 0;
+                record(operation, timed, nanoseconds, entries, bytes);
+            }
+        }
+        void scanned(std::uint64_t count) { entries += count; }
+        void allocated(std::uint64_t count) { bytes += count; }
+
+    private:
+        Operation operation;
+        bool active;
+        bool timed;
+        std::uint64_t entries = 0;
+        std::uint64_t bytes = 0;
+        std::chrono::steady_clock::time_point start;
+#endif
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+    };
+
+    static void enable(bool on) { recording.store(on && compiledIn, std::memory_order_relaxed); }
+    static bool enabled() { return recording.load(std::memory_order_relaxed); }
+
+    static Totals snapshot();
+    static std::string prometheusText();
+    static bool writePrometheus(int fd);
+    static bool writePrometheusFile(const std::string& filename);
+    static bool dumpOnSignal(int signal, const std::string& filename); // Starts a thread that rewrites filename on every signal; POSIX only.
+    static void stopDumping();
+
+    static std::size_t bucketOf(std::uint64_t nanoseconds);
+    static std::uint64_t bucketLimit(std::size_t bucket); // Largest value counted in bucket.
+
+private:
+    static void record(Operation operation, bool timed, std::uint64_t nanoseconds, std::uint64_t scanned, std::uint64_t allocatedBytes);
+
+    static inline std::atomic<bool> recording{false};
+    static inline thread_local unsigned searchCalls = 0;
+};
+
+#endif // METRICS_H
@@ -0,0 +1,98 @@
+// File: PalindromeIndex.cpp
+// Summary:
+// This file implements the PalindromeIndex class: the palindrome check itself, inserting a
+// newly added word, and listing the palindromes of a letter range.
+//
+// Input:
+// - Names as string views, and letter ranges as characters.
+//
+// Output:
+// - Entry positions in dictionary order.
+//
+#include "PalindromeIndex.h"
+#include "CaseFold.h"
+#include <algorithm>
+#include <cctype>
+#include <utility>
+
+bool PalindromeIndex::isPalindrome(std::string_view word) {
+    return CaseFold::isPalindrome(word);
+}
+
+unsigned char PalindromeIndex::bucketOf(std::string_view name) {
+    return static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(name[0])));
+}
+
+void PalindromeIndex::reset() {
+    table.assign(bucketCount + 1, 0);
+}
+
+void PalindromeIndex::clear() {
+    external = nullptr;
+    externalSize = 0;
+    externalOwner.reset();
+    reset();
+}
+
+bool PalindromeIndex::attach(const std::uint32_t* serialized, std::size_t serializedSize, std::size_t entryCount, std::shared_ptr<const void> owner) {
+    if (serializedSize < bucketCount + 1 || serialized[0] != 0 || serialized[bucketCount] != serializedSize - (bucketCount + 1)) {
+        return false;
+    }
+    for (std::size_t bucket = 0; bucket < bucketCount; ++bucket) { // Starts must never step backwards
+        if (serialized[bucket] > serialized[bucket + 1]) {
+            return false;
+        }
+    }
+    for (std::size_t i = bucketCount + 1; i < serializedSize; ++i) {
+        if (serialized[i] >= entryCount) {
+            return false;
+        }
+    }
+
+    table.clear();
+    table.shrink_to_fit();
+    external = serialized;
+    externalSize = serializedSize;
+    externalOwner = std::move(owner);
+    return true;
+}
+
+void PalindromeIndex::detach() {
+    if (external == nullptr) {
+        return;
+    }
+    table.assign(external, external + externalSize);
+    external = nullptr;
+    externalSize = 0;
+    externalOwner.reset();
+}
+
+void PalindromeIndex::insert(std::uint32_t entry, std::string_view name) {
+    if (name.empty() || !isPalindrome(name)) {
+        return;
+    }
+
+    detach();
+    const unsigned char bucket = bucketOf(name);
+    table.insert(table.begin() + bucketCount + 1 + table[bucket + 1], entry); // Newest position goes at the end of its bucket
+    for (std::size_t later = bucket + 1; later <= bucketCount; ++later) {
+        ++table[later];
+    }
+}
+
+std::vector<std::uint32_t> PalindromeIndex::find(char firstLetter, char lastLetter) const {
+    std::vector<std::uint32_t> palindromes;
+    const auto first = static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(firstLetter)));
+    const auto last = static_cast<unsigned char>(std::toupper(static_cast<unsigned char>(lastLetter)));
+    if (first > last) {
+        return palindromes;
+    }
+
+    const std::uint32_t* starts = data();
+    const std::uint32_t* positions = starts + bucketCount + 1;
+    palindromes.assign(positions + starts[first], positions + starts[last + 1]);
+    if (first != last) {
+        std::sort(palindromes.begin(), palindromes.end()); // Interleave the buckets back into dictionary order
+    }
+    return palindromes;
+}
@@ -0,0 +1,87 @@
+// File: PalindromeIndex.h
+// Summary:
+// This file defines the PalindromeIndex class, which records the positions of every
+// palindrome in the dictionary bucketed by the uppercased first character of its name.
+// Palindrome status is worked out once per entry, when it is loaded or added, so listing
+// the palindromes of any letter range only costs the size of the output.
+//
+// Input:
+// - build and insert take entry positions together with the entry names.
+// - find takes the first and last letter of the range to list, in either case.
+//
+// Output:
+// - find returns the positions of the palindromes in the range, in dictionary order.
+// - The whole index is one array (257 bucket starts followed by the positions), which is
+//   what gets stored in snapshots. Like the other indexes it can be attached to a mapped
+//   snapshot and is copied into owned storage on the first insert.
+//
+#ifndef PALINDROMEINDEX_H
+#define PALINDROMEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class PalindromeIndex {
+public:
+    static constexpr std::size_t bucketCount = 256; // One bucket per possible first byte
+
+    PalindromeIndex() { reset(); }
+
+    static bool isPalindrome(std::string_view word); // Checks a word ignoring case, without copying it.
+
+    void clear(); // The clear function removes every entry.
+    bool attach(const std::uint32_t* table, std::size_t tableSize, std::size_t entryCount, std::shared_ptr<const void> owner); // Uses a serialized table without copying it; false if a bucket start or position is out of range.
+    void detach(); // The detach function copies an attached table into owned storage.
+
+    const std::uint32_t* data() const { return external ? external : table.data(); }
+    std::size_t tableSize() const { return external ? externalSize : table.size(); }
+    std::size_t size() const { return tableSize() - (bucketCount + 1); } // Number of palindromes indexed
+
+    template <typename NameAt>
+    void build(std::size_t entryCount, NameAt nameAt); // The build function indexes entries 0 to entryCount - 1.
+
+    void insert(std::uint32_t entry, std::string_view name); // Records entry if name is a palindrome, entry must be the newest position.
+    std::vector<std::uint32_t> find(char firstLetter, char lastLetter) const; // Lists palindromes whose first letter is in the range.
+
+private:
+    static unsigned char bucketOf(std::string_view name);
+    void reset();
+
+    std::vector<std::uint32_t> table; // bucketCount + 1 starts, then the positions grouped by bucket
+    const std::uint32_t* external = nullptr;
+    std::size_t externalSize = 0;
+    std::shared_ptr<const void> externalOwner;
+};
+
+template <typename NameAt>
+void PalindromeIndex::build(std::size_t entryCount, NameAt nameAt) {
+    clear();
+
+    std::vector<std::uint32_t> found;
+    std::vector<std::uint32_t> counts(bucketCount, 0);
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        std::string_view name = nameAt(i);
+        if (!name.empty() && isPalindrome(name)) {
+            found.push_back(static_cast<std::uint32_t>(i));
+            ++counts[bucketOf(name)];
+        }
+    }
+
+    table.resize(bucketCount + 1 + found.size());
+    std::uint32_t start = 0;
+    for (std::size_t bucket = 0; bucket < bucketCount; ++bucket) {
+        table[bucket] = start;
+        start += counts[bucket];
+    }
+    table[bucketCount] = start;
+
+    std::vector<std::uint32_t> next(table.begin(), table.begin() + bucketCount);
+    for (std::uint32_t position : found) { // Positions were found in order, so each bucket stays sorted
+        table[bucketCount + 1 + next[bucketOf(nameAt(position))]++] = position;
+    }
+}
+
+#endif // PALINDROMEINDEX_H
@@ -0,0 +1,69 @@
+// File: PrefixIndex.cpp
+// Summary:
+// This file implements the non-template parts of the PrefixIndex class: the case-insensitive
+// prefix test, and attaching to or detaching from borrowed storage.
+//
+// Input:
+// - Names and prefixes as string views, compared with CaseFold.
+//
+// Output:
+// - attach returns False if a mapped node table points outside the order or itself.
+//
+#include "PrefixIndex.h"
+#include "CaseFold.h"
+#include <utility>
+
+void PrefixIndex::clear() {
+    order.clear();
+    order.shrink_to_fit();
+    nodes.clear();
+    nodes.shrink_to_fit();
+    external = nullptr;
+    externalSize = 0;
+    externalNodes = nullptr;
+    externalNodeCount = 0;
+    externalOwner.reset();
+}
+
+bool PrefixIndex::attach(const std::uint32_t* sorted, std::size_t count, const Node* table, std::size_t tableSize, std::shared_ptr<const void> owner) {
+    if (tableSize == 0 || table[0].begin != 0 || table[0].end != count) {
+        return false;
+    }
+    for (std::size_t n = 0; n < tableSize; ++n) { // Reject tables that would lead a query out of bounds
+        const Node& node = table[n];
+        if (node.begin > node.end || node.end > count
+            || (node.childCount > 0 && (node.firstChild <= n || node.firstChild + node.childCount > tableSize))) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        if (sorted[i] >= count) {
+            return false;
+        }
+    }
+
+    clear();
+    external = sorted;
+    externalSize = count;
+    externalNodes = table;
+    externalNodeCount = tableSize;
+    externalOwner = std::move(owner);
+    return true;
+}
+
+void PrefixIndex::detach() {
+    if (external == nullptr) {
+        return;
+    }
+    order.assign(external, external + externalSize);
+    nodes.assign(externalNodes, externalNodes + externalNodeCount);
+    external = nullptr;
+    externalSize = 0;
+    externalNodes = nullptr;
+    externalNodeCount = 0;
+    externalOwner.reset();
+}
+
+bool PrefixIndex::startsWithIgnoreCase(std::string_view name, std::string_view prefix) {
+    return name.size() >= prefix.size() && CaseFold::equalsIgnoreCase(name.substr(0, prefix.size()), prefix);
+}
@@ -0,0 +1,244 @@
+// File: PrefixIndex.h
+// Summary:
+// This file defines the PrefixIndex class, which answers "every word starting with X" for
+// autocomplete. Entry positions are kept sorted by lowercased name, so the words sharing a
+// prefix form one contiguous range, and a compact trie of ranges over that order leads from
+// a prefix to its range one character at a time. Ranges of leafSize entries or fewer get no
+// children; the last characters of a prefix are matched by scanning that small range.
+//
+// Input:
+// - build and insert take entry positions and a callable returning the name at a position.
+// - find takes the prefix (matched ignoring case) and the largest number of results wanted.
+//
+// Output:
+// - find returns matching positions in alphabetical order. Its cost is the prefix length
+//   plus the size of the output; the names are never searched or compared in bulk.
+// - The sorted positions and the node array are what get stored in snapshots. Like the other
+//   indexes they can be attached to a mapped snapshot and are copied on the first insert.
+//
+#ifndef PREFIXINDEX_H
+#define PREFIXINDEX_H
+
+#include "CaseFold.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class PrefixIndex {
+public:
+    static constexpr std::size_t leafSize = 16; // Ranges up to this size are scanned instead of split further
+    static constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+
+    struct Node {
+        std::uint32_t begin;      // First position in the sorted order covered by this node
+        std::uint32_t end;        // One past the last covered position
+        std::uint32_t firstChild; // Children are consecutive nodes, sorted by label
+        std::uint16_t childCount; // 0 for a leaf
+        std::uint8_t label;       // Lowercased character that leads here from the parent
+        std::uint8_t reserved;
+    };
+
+    void clear(); // The clear function removes every entry and node.
+    bool attach(const std::uint32_t* sorted, std::size_t count, const Node* table, std::size_t tableSize, std::shared_ptr<const void> owner); // Uses a mapped order and node table without copying them.
+    void detach(); // The detach function copies an attached index into owned storage.
+
+    std::size_t size() const { return external ? externalSize : order.size(); }
+    const std::uint32_t* data() const { return external ? external : order.data(); }
+    std::size_t nodeCount() const { return external ? externalNodeCount : nodes.size(); }
+    const Node* nodeData() const { return external ? externalNodes : nodes.data(); }
+
+    template <typename NameAt>
+    void build(std::size_t entryCount, NameAt nameAt); // The build function indexes entries 0 to entryCount - 1.
+
+    template <typename NameAt>
+    void insert(std::uint32_t entry, NameAt nameAt); // The insert function adds one entry, updating only the nodes on its path and the ranges after it.
+
+    template <typename NameAt>
+    std::vector<std::uint32_t> find(std::string_view prefix, std::size_t limit, NameAt nameAt) const; // Lists up to limit entries whose names start with prefix.
+
+    static bool startsWithIgnoreCase(std::string_view name, std::string_view prefix);
+
+private:
+    static unsigned char labelOf(char c) { return static_cast<unsigned char>(CaseFold::lower(c)); } // Trie labels are lowercased bytes.
+    template <typename NameAt>
+    void buildNodes(NameAt nameAt);
+    template <typename NameAt>
+    void split(std::size_t n, std::size_t depth, NameAt nameAt); // Gives node n, whose names share depth characters, children while it and they are larger than leafSize.
+
+    std::vector<std::uint32_t> order; // Entry positions sorted by lowercased name, ties by position
+    std::vector<Node> nodes;          // nodes[0] is the root and covers the whole order
+    const std::uint32_t* external = nullptr;
+    std::size_t externalSize = 0;
+    const Node* externalNodes = nullptr;
+    std::size_t externalNodeCount = 0;
+    std::shared_ptr<const void> externalOwner;
+};
+
+static_assert(sizeof(PrefixIndex::Node) == 16, "PrefixIndex::Node is stored in snapshots, its layout must not change");
+
+template <typename NameAt>
+void PrefixIndex::build(std::size_t entryCount, NameAt nameAt) {
+    clear();
+    order.resize(entryCount);
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        order[i] = static_cast<std::uint32_t>(i);
+    }
+    std::stable_sort(order.begin(), order.end(), [&nameAt](std::uint32_t a, std::uint32_t b) {
+        return CaseFold::compareIgnoreCase(nameAt(a), nameAt(b)) < 0;
+    });
+    buildNodes(nameAt);
+}
+
+template <typename NameAt>
+void PrefixIndex::insert(std::uint32_t entry, NameAt nameAt) {
+    detach();
+    std::string_view name = nameAt(entry);
+    auto where = std::upper_bound(order.begin(), order.end(), name, [&nameAt](std::string_view key, std::uint32_t other) {
+        return CaseFold::compareIgnoreCase(key, nameAt(other)) < 0;
+    });
+    const auto position = static_cast<std::uint32_t>(where - order.begin());
+    order.insert(where, entry);
+    if (nodes.empty()) {
+        buildNodes(nameAt);
+        return;
+    }
+
+    // Follow the new name down the trie as find does; the nodes on that path gain the entry
+    std::vector<std::size_t> path{0};
+    std::size_t depth = 0;
+    unsigned char missingLabel = 0;
+    bool missing = false;
+    while (nodes[path.back()].childCount > 0 && depth < name.size()) {
+        const Node& parent = nodes[path.back()];
+        const unsigned char label = labelOf(name[depth]);
+        const Node* first = nodes.data() + parent.firstChild;
+        const Node* last = first + parent.childCount;
+        const Node* child = std::lower_bound(first, last, label, [](const Node& node, unsigned char key) { return node.label < key; });
+        if (child == last || child->label != label) {
+            missingLabel = label;
+            missing = true;
+            break;
+        }
+        path.push_back(static_cast<std::size_t>(child - nodes.data()));
+        ++depth;
+    }
+
+    // Ranges starting at or after the new position move up by one; ranges on the path grow instead
+    for (Node& node : nodes) {
+        if (node.begin >= position) {
+            ++node.begin;
+            ++node.end;
+        }
+    }
+    for (std::size_t n : path) {
+        if (nodes[n].begin > position) {
+            nodes[n].begin = position; // Started at position, so the loop above moved it
+        } else {
+            ++nodes[n].end;
+        }
+    }
+
+    const std::size_t last = path.back();
+    if (missing) { // A new first letter under this node: a leaf of one entry among its children
+        Node& parent = nodes[last];
+        std::size_t at = parent.firstChild;
+        while (at < parent.firstChild + parent.childCount && nodes[at].label < missingLabel) {
+            ++at;
+        }
+        ++parent.childCount;
+        for (std::size_t n = 0; n < nodes.size(); ++n) {
+            if (n != last && nodes[n].childCount > 0 && nodes[n].firstChild >= at) {
+                ++nodes[n].firstChild;
+            }
+        }
+        nodes.insert(nodes.begin() + static_cast<std::ptrdiff_t>(at), Node{position, position + 1, 0, 0, missingLabel, 0});
+    } else if (nodes[last].childCount == 0) {
+        split(last, depth, nameAt); // Only does anything once the leaf outgrows leafSize
+    }
+}
+
+template <typename NameAt>
+void PrefixIndex::buildNodes(NameAt nameAt) {
+    nodes.clear();
+    nodes.push_back(Node{0, static_cast<std::uint32_t>(order.size()), 0, 0, 0, 0});
+    split(0, 0, nameAt);
+}
+
+template <typename NameAt>
+void PrefixIndex::split(std::size_t start, std::size_t startDepth, NameAt nameAt) {
+    std::vector<std::pair<std::size_t, std::size_t>> pending{{start, startDepth}}; // Node and the characters shared under it
+    for (std::size_t next = 0; next < pending.size(); ++next) { // Breadth first, so siblings end up next to each other
+        const std::size_t n = pending[next].first;
+        const std::size_t depth = pending[next].second;
+        const Node node = nodes[n];
+        if (node.end - node.begin <= leafSize) {
+            continue;
+        }
+
+        std::size_t i = node.begin;
+        while (i < node.end && nameAt(order[i]).size() <= depth) { // Names that end here sort before the rest
+            ++i;
+        }
+        const std::size_t firstChild = nodes.size();
+        while (i < node.end) {
+            const unsigned char label = labelOf(nameAt(order[i])[depth]);
+            std::size_t j = i + 1;
+            while (j < node.end && labelOf(nameAt(order[j])[depth]) == label) {
+                ++j;
+            }
+            nodes.push_back(Node{static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(j), 0, 0, label, 0});
+            pending.emplace_back(nodes.size() - 1, depth + 1);
+            i = j;
+        }
+        nodes[n].firstChild = static_cast<std::uint32_t>(firstChild);
+        nodes[n].childCount = static_cast<std::uint16_t>(nodes.size() - firstChild);
+    }
+}
+
+template <typename NameAt>
+std::vector<std::uint32_t> PrefixIndex::find(std::string_view prefix, std::size_t limit, NameAt nameAt) const {
+    std::vector<std::uint32_t> matches;
+    const Node* table = nodeData();
+    if (nodeCount() == 0 || limit == 0) {
+        return matches;
+    }
+
+    // Follow the prefix down the trie until it ends or a leaf is reached
+    std::size_t n = 0;
+    std::size_t depth = 0;
+    while (depth < prefix.size() && table[n].childCount > 0) {
+        const unsigned char label = labelOf(prefix[depth]);
+        const Node* first = table + table[n].firstChild;
+        const Node* last = first + table[n].childCount;
+        const Node* child = std::lower_bound(first, last, label, [](const Node& node, unsigned char key) { return node.label < key; });
+        if (child == last || child->label != label) {
+            return matches;
+        }
+        n = static_cast<std::size_t>(child - table);
+        ++depth;
+    }
+
+    const std::uint32_t* sorted = data();
+    std::size_t begin = table[n].begin;
+    std::size_t end = table[n].end;
+    if (depth < prefix.size()) { // Stopped at a leaf, so at most leafSize names are left to check
+        while (begin < end && !startsWithIgnoreCase(nameAt(sorted[begin]), prefix)) {
+            ++begin;
+        }
+        std::size_t last = begin;
+        while (last < end && startsWithIgnoreCase(nameAt(sorted[last]), prefix)) {
+            ++last;
+        }
+        end = last;
+    }
+
+    end = begin + std::min(end - begin, limit);
+    matches.assign(sorted + begin, sorted + end);
+    return matches;
+}
+
+#endif // PREFIXINDEX_H
@@ -0,0 +1,231 @@
+// File: QueryProcessor.cpp
+// Summary:
+// This file implements the QueryProcessor class: reading blocks of query lines, answering
+// the lookups of a block as one batch and the commands one by one, and writing the answers
+// of each block at once.
+//
+// Input:
+// - Raw bytes from a file descriptor, cut into lines at '\n'.
+//
+// Output:
+// - Answer lines in query order, written in blocks.
+//
+#include "QueryProcessor.h"
+#include "Tokenizer.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+}
+
+// Takes the count off the end of a command's arguments when the last space separated token is
+// a number, capped at maximumResults. False if the number does not fit in a size_t.
+bool takeCount(std::string_view& arguments, std::size_t& limit) {
+    const std::size_t space = arguments.find_last_of(' ');
+    if (space == std::string_view::npos) {
+        return true;
+    }
+    const std::string_view count = arguments.substr(space + 1);
+    if (count.empty() || !std::all_of(count.begin(), count.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        return true;
+    }
+    std::size_t requested = 0;
+    if (std::from_chars(count.data(), count.data() + count.size(), requested).ec != std::errc()) {
+        return false;
+    }
+    arguments = arguments.substr(0, space);
+    limit = std::min(requested, QueryProcessor::maximumResults);
+    return true;
+}
+
+bool isOneWord(std::string_view arguments) {
+    return !arguments.empty() && arguments.find(' ') == std::string_view::npos;
+}
+
+long readSome(int fd, char* buffer, std::size_t size) {
+#ifdef _WIN32
+    return _read(fd, buffer, static_cast<unsigned>(size));
+#else
+    ssize_t got;
+    do {
+        got = ::read(fd, buffer, size);
+    } while (got < 0 && errno == EINTR);
+    return static_cast<long>(got);
+#endif
+}
+
+bool writeAll(int fd, std::string_view bytes) {
+    while (!bytes.empty()) {
+#ifdef _WIN32
+        const int written = _write(fd, bytes.data(), static_cast<unsigned>(bytes.size()));
+#else
+        const ssize_t written = ::write(fd, bytes.data(), bytes.size());
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+#endif
+        if (written <= 0) {
+            return false;
+        }
+        bytes.remove_prefix(static_cast<std::size_t>(written));
+    }
+    return true;
+}
+
+} // namespace
+
+// - run(int inputFd, int outputFd): Reads whatever the input has ready (up to blockBytes),
+//   answers the complete lines and carries a partial last line over to the next read.
+bool QueryProcessor::run(int inputFd, int outputFd) {
+    std::string buffer(blockBytes, '\0');
+    std::string output;
+    std::size_t carried = 0; // Bytes of an unfinished line at the start of buffer
+
+    while (true) {
+        if (carried == buffer.size()) {
+            buffer.resize(buffer.size() * 2); // One line longer than a block
+        }
+        const long got = readSome(inputFd, &buffer[carried], buffer.size() - carried);
+        if (got < 0) {
+            return false;
+        }
+        const std::size_t filled = carried + static_cast<std::size_t>(got);
+        if (got == 0) { // End of input; a last line without '\n' is still a query
+            output.clear();
+            if (filled > 0) {
+                buffer.resize(filled);
+                buffer += '\n';
+                process(buffer, output);
+            }
+            return writeAll(outputFd, output);
+        }
+
+        const std::size_t lastNewline = std::string_view(buffer.data(), filled).rfind('\n');
+        if (lastNewline == std::string_view::npos) {
+            carried = filled;
+            continue;
+        }
+        output.clear();
+        process(std::string_view(buffer.data(), lastNewline + 1), output);
+        if (!writeAll(outputFd, output)) {
+            return false;
+        }
+        carried = filled - (lastNewline + 1);
+        buffer.replace(0, carried, buffer, lastNewline + 1, carried);
+    }
+}
+
+void QueryProcessor::process(std::string_view block, std::string& output) {
+    lines.clear();
+    lookups.clear();
+    for (std::size_t start = 0, newline; (newline = block.find('\n', start)) != std::string_view::npos; start = newline + 1) {
+        std::string_view line = block.substr(start, newline - start);
+        while (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        lines.push_back(line);
+    }
+
+    // Commands are answered as they come; everything else is an exact lookup, answered as one batch
+    std::vector<std::string> answers;
+    std::vector<bool> isCommand(lines.size(), false);
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        std::string answer;
+        if (answerCommand(lines[i], answer)) {
+            isCommand[i] = true;
+            answers.push_back(std::move(answer));
+        } else {
+            lookups.push_back(lines[i]);
+        }
+    }
+    const std::vector<std::uint32_t> positions = dictionary.searchWordsInDictionary(lookups);
+
+    std::size_t nextLookup = 0, nextAnswer = 0;
+    for (std::size_t i = 0; i < lines.size(); ++i) {
+        if (isCommand[i]) {
+            output += answers[nextAnswer++];
+            continue;
+        }
+        const std::uint32_t position = positions[nextLookup++];
+        output.append(lines[i]);
+        if (position != WordIndex::npos) {
+            output.append("\t").append(dictionary.typeAt(position)).append("\t").append(dictionary.definitionAt(position));
+        }
+        output += '\n';
+    }
+    queries += lines.size();
+}
+
+// - answerCommand(std::string_view line, std::string& output): Answers line if it is one of the
+//   commands, otherwise returns false and leaves it to the lookup batch.
+bool QueryProcessor::answerCommand(std::string_view line, std::string& output) {
+    std::vector<std::uint32_t> found;
+    std::string_view arguments;
+    std::size_t limit = defaultResults;
+    if (startsWith(line, "rhyme ")) {
+        arguments = line.substr(6);
+        if (!takeCount(arguments, limit) || !isOneWord(arguments)) {
+            return false;
+        }
+        found = dictionary.findRhymingWords(std::string(arguments));
+    } else if (startsWith(line, "prefix ")) {
+        arguments = line.substr(7);
+        if (!takeCount(arguments, limit) || !isOneWord(arguments)) {
+            return false;
+        }
+        found = dictionary.findWordsWithPrefix(arguments, limit);
+    } else if (startsWith(line, "similar ")) {
+        arguments = line.substr(8);
+        if (!takeCount(arguments, limit) || !isOneWord(arguments)) {
+            return false;
+        }
+        for (const FuzzyIndex::Match& match : dictionary.findSimilarWords(arguments, ImprovedDictionary::defaultFuzzyDistance, limit)) {
+            found.push_back(match.entry);
+        }
+    } else if (startsWith(line, "define ")) {
+        arguments = line.substr(7);
+        if (!takeCount(arguments, limit)) {
+            return false;
+        }
+        Tokenizer::split(arguments, terms);
+        found = dictionary.findWordsByDefinition(terms);
+    } else if (startsWith(line, "palindromes ")) {
+        arguments = line.substr(12);
+        if (!takeCount(arguments, limit)) {
+            return false;
+        }
+        Tokenizer::split(arguments, terms);
+        if (terms.size() != 2 || terms[0].size() != 1 || terms[1].size() != 1) {
+            return false;
+        }
+        found = dictionary.findPalindromes(terms[0][0], terms[1][0]);
+    } else {
+        return false;
+    }
+    if (found.size() > limit) {
+        found.resize(limit);
+    }
+    output.append(line).append("\t");
+    appendNames(found, output);
+    output += '\n';
+    return true;
+}
+
+void QueryProcessor::appendNames(const std::vector<std::uint32_t>& positions, std::string& output) const {
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        if (i > 0) {
+            output += ' ';
+        }
+        output.append(dictionary.nameAt(positions[i]));
+    }
+}
@@ -0,0 +1,66 @@
+// File: QueryProcessor.h
+// Summary:
+// This file defines the QueryProcessor class, the non-interactive front end used by
+// "dictionary_program --stream". It reads newline separated queries, answers them with the
+// ImprovedDictionary queries the menu uses, and writes one answer line per query line, so
+// the output can be pasted next to the input.
+//
+// Input:
+// - One query per line:
+//     <word>                               exact lookup (a line that is not one of the commands below)
+//     rhyme <word> [count]                 words rhyming with word, in dictionary order
+//     prefix <letters> [count]             words starting with letters, alphabetically
+//     similar <word> [count]               words within two edits of word, closest first
+//     define <term> [term ...] [count]     words whose definitions use every term
+//     palindromes <first> <last> [count]   palindromes starting with a letter from first to last
+//   Every command answers with its first count matches: defaultResults when count is left
+//   out, and never more than maximumResults. A trailing number is always read as the count,
+//   so define cannot search for a number as its last term. Trailing '\r' characters are
+//   ignored.
+//
+// Output:
+// - For a lookup, "<word>\t<type>\t<definition>" when it is found and just "<word>" when it
+//   is not. For a command, "<command line>\t" followed by the matching names separated by
+//   spaces. An unknown or malformed command is answered like a lookup that missed.
+//
+// Comments:
+// - Input is read in blocks of up to blockBytes. The lookups of a block are answered
+//   together through searchWordsInDictionary (lowercased once, repeated words looked up
+//   once, spread over the thread pool), and the answers of a block are written with one
+//   write, so there is no flush per line. A block is answered as soon as it is read, so a
+//   program feeding queries through a pipe gets its answers without closing the pipe.
+//
+#ifndef QUERYPROCESSOR_H
+#define QUERYPROCESSOR_H
+
+#include "ImprovedDictionary.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class QueryProcessor {
+public:
+    static constexpr std::size_t blockBytes = std::size_t(1) << 20;
+    static constexpr std::size_t defaultResults = 100;  // A short prefix or a common term would otherwise list a large part of the dictionary
+    static constexpr std::size_t maximumResults = 1000; // Bounds the answer a single query can ask for
+
+    explicit QueryProcessor(const ImprovedDictionary& dictionary) : dictionary(dictionary) {}
+
+    bool run(int inputFd, int outputFd); // The run function answers every line of inputFd until end of file; false on a read or write error.
+    void process(std::string_view lines, std::string& output); // The process function appends the answers to complete lines to output.
+    std::size_t queryCount() const { return queries; }
+
+private:
+    bool answerCommand(std::string_view line, std::string& output);
+    void appendNames(const std::vector<std::uint32_t>& positions, std::string& output) const;
+
+    const ImprovedDictionary& dictionary;
+    std::vector<std::string_view> lines;   // Reused for every block
+    std::vector<std::string_view> lookups; // The lines of a block that are exact lookups
+    std::vector<std::string_view> terms;
+    std::size_t queries = 0;
+};
+
+#endif // QUERYPROCESSOR_H
@@ -0,0 +1,305 @@
+// File: QueryServer.cpp
+// Summary:
+// This file implements the QueryServer class: the epoll loop that accepts clients and
+// dispatches ready connections, and the worker side that reads, answers and writes them.
+//
+// Input:
+// - Query lines from clients on a Unix domain socket or a 127.0.0.1 TCP port.
+//
+// Output:
+// - Answer lines written back on the connection each query came from.
+//
+#include "QueryServer.h"
+#include "QueryProcessor.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <iostream>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+
+QueryServer::~QueryServer() {
+    for (int fd : {listenFd, epollFd, wakeFd}) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+    if (!socketPath.empty()) {
+        unlink(socketPath.c_str());
+    }
+}
+
+bool QueryServer::listenUnix(const std::string& path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path is empty or too long: " << path << "\n";
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+        unlink(path.c_str()); // Left behind by a server that did not shut down cleanly
+    }
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Cannot listen on " << path << ": " << std::strerror(errno) << "\n";
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    socketPath = path;
+    return listenOn(fd);
+}
+
+bool QueryServer::listenTcp(unsigned short port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Local clients only; the protocol has no authentication
+
+    const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    const int reuse = 1;
+    if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0
+        || bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        std::cerr << "Cannot listen on 127.0.0.1:" << port << ": " << std::strerror(errno) << "\n";
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    return listenOn(fd);
+}
+
+// - listenOn(int fd): Starts listening on a bound socket and sets up the epoll descriptor and
+//   the eventfd that stop uses to wake the loop.
+bool QueryServer::listenOn(int fd) {
+    if (listenFd >= 0) {
+        std::cerr << "The server is already listening.\n";
+        close(fd);
+        return false;
+    }
+    listenFd = fd;
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (listen(listenFd, SOMAXCONN) != 0 || epollFd < 0 || wakeFd < 0) {
+        std::cerr << "Cannot start the server: " << std::strerror(errno) << "\n";
+        return false;
+    }
+    epoll_event listening{};
+    listening.events = EPOLLIN;
+    listening.data.ptr = &listenFd;
+    epoll_event waking{};
+    waking.events = EPOLLIN;
+    waking.data.ptr = &wakeFd;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &listening) == 0
+        && epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &waking) == 0;
+}
+
+void QueryServer::stop() {
+    stopping.store(true);
+    if (wakeFd >= 0) {
+        const std::uint64_t one = 1;
+        const ssize_t written = write(wakeFd, &one, sizeof(one)); // write is async-signal-safe
+        (void)written;
+    }
+}
+
+bool QueryServer::run(unsigned workerCount) {
+    if (listenFd < 0 || epollFd < 0 || wakeFd < 0) {
+        std::cerr << "The server is not listening.\n";
+        return false;
+    }
+    {
+        ThreadPool workers(std::max(1u, workerCount));
+        epoll_event events[64];
+        while (!stopping.load()) {
+            const int ready = epoll_wait(epollFd, events, 64, -1);
+            if (ready < 0 && errno != EINTR) {
+                std::cerr << "epoll_wait failed: " << std::strerror(errno) << "\n";
+                break;
+            }
+            for (int i = 0; i < ready; ++i) {
+                if (events[i].data.ptr == &listenFd) {
+                    acceptConnections();
+                } else if (events[i].data.ptr != &wakeFd) {
+                    Connection* connection = static_cast<Connection*>(events[i].data.ptr);
+                    workers.submit([this, connection]() { serve(connection); });
+                }
+            }
+        }
+    } // The pool finishes the connections already handed to it before its workers stop
+
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    for (Connection* connection : connections) {
+        close(connection->fd);
+        delete connection;
+    }
+    connections.clear();
+    return true;
+}
+
+void QueryServer::acceptConnections() {
+    while (true) {
+        const int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            return; // EAGAIN once the backlog is empty; anything else (EMFILE) is retried on the next event
+        }
+        if (socketPath.empty()) {
+            const int noDelay = 1; // Answers are written in whole batches, so Nagle only adds latency
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        Connection* connection = new Connection(fd);
+        {
+            std::lock_guard<std::mutex> lock(connectionsMutex);
+            connections.insert(connection);
+        }
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLONESHOT;
+        event.data.ptr = connection;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            closeConnection(connection);
+        }
+    }
+}
+
+// - serve(Connection* connection): Reads up to one block from the client, answers its
+//   complete lines, writes what the socket takes and re-arms the connection. The connection
+//   must not be touched after rearmOrClose, since another worker may already have it.
+void QueryServer::serve(Connection* connection) {
+    Connection& client = *connection;
+    char buffer[readBytes];
+    bool failed = false;
+
+    // Read only while the client is not far behind on its answers
+    std::size_t received = 0;
+    while (!client.finished && client.output.size() - client.outputSent < maxPendingOutput
+           && received < QueryProcessor::blockBytes) {
+        const ssize_t got = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (got > 0) {
+            client.input.append(buffer, static_cast<std::size_t>(got));
+            received += static_cast<std::size_t>(got);
+        } else if (got == 0) {
+            client.finished = true;
+        } else if (errno != EINTR) {
+            failed = errno != EAGAIN && errno != EWOULDBLOCK;
+            break;
+        }
+    }
+
+    if (!failed) {
+        answer(client, client.finished);
+        failed = client.input.size() > maxLineBytes; // No '\n' in sight
+    }
+
+    while (!failed && client.outputSent < client.output.size()) {
+        const ssize_t sent = send(client.fd, client.output.data() + client.outputSent,
+                                  client.output.size() - client.outputSent, MSG_NOSIGNAL);
+        if (sent > 0) {
+            client.outputSent += static_cast<std::size_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else {
+            failed = !(sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+            break;
+        }
+    }
+    if (client.outputSent == client.output.size()) {
+        client.output.clear();
+        client.outputSent = 0;
+    } else if (client.outputSent > client.output.size() / 2) {
+        client.output.erase(0, client.outputSent); // Keep the buffer from only ever growing
+        client.outputSent = 0;
+    }
+
+    if (failed) {
+        closeConnection(connection);
+    } else {
+        rearmOrClose(connection);
+    }
+}
+
+// - answer(Connection& client, bool flushPartialLine): Answers every complete line of the
+//   client's input as one batch against one pinned version of the dictionary. Once the
+//   client has finished sending, a last line without '\n' is answered too.
+void QueryServer::answer(Connection& client, bool flushPartialLine) {
+    if (flushPartialLine && !client.input.empty() && client.input.back() != '\n') {
+        client.input += '\n';
+    }
+    const std::size_t lastNewline = client.input.rfind('\n');
+    if (lastNewline == std::string::npos) {
+        return;
+    }
+    ConcurrentDictionary::Reader reader = dictionary.read();
+    QueryProcessor processor(*reader);
+    processor.process(std::string_view(client.input.data(), lastNewline + 1), client.output);
+    queries.fetch_add(processor.queryCount(), std::memory_order_relaxed);
+    client.input.erase(0, lastNewline + 1);
+}
+
+void QueryServer::rearmOrClose(Connection* connection) {
+    const bool pending = connection->outputSent < connection->output.size();
+    epoll_event event{};
+    event.events = EPOLLONESHOT;
+    if (!connection->finished && connection->output.size() - connection->outputSent < maxPendingOutput) {
+        event.events |= EPOLLIN;
+    }
+    if (pending) {
+        event.events |= EPOLLOUT;
+    }
+    event.data.ptr = connection;
+    if ((!pending && connection->finished) || epoll_ctl(epollFd, EPOLL_CTL_MOD, connection->fd, &event) != 0) {
+        closeConnection(connection);
+    }
+}
+
+void QueryServer::closeConnection(Connection* connection) {
+    std::lock_guard<std::mutex> lock(connectionsMutex);
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, connection->fd, nullptr);
+    close(connection->fd);
+    connections.erase(connection);
+    delete connection;
+}
+
+#else
+
+QueryServer::~QueryServer() = default;
+
+bool QueryServer::listenUnix(const std::string&) {
+    std::cerr << "The query server needs epoll, which this platform does not have.\n";
+    return false;
+}
+
+bool QueryServer::listenTcp(unsigned short) {
+    std::cerr << "The query server needs epoll, which this platform does not have.\n";
+    return false;
+}
+
+bool QueryServer::run(unsigned) {
+    return false;
+}
+
+void QueryServer::stop() {
+    stopping.store(true);
+}
+
+#endif
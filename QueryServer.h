@@ -0,0 +1,89 @@
+// File: QueryServer.h
+// Summary:
+// This file defines the QueryServer class, used by "dictionary_program --serve". It loads
+// nothing itself: it serves the queries of QueryProcessor over a Unix domain socket or a
+// TCP port on 127.0.0.1, so many local clients share one loaded dictionary instead of each
+// loading their own.
+//
+// Input:
+// - The ConcurrentDictionary to answer from; it may be reloaded or added to while serving.
+// - listenUnix or listenTcp chooses where clients connect. Clients send the same lines as
+//   "--stream" reads (see QueryProcessor.h), as many as they like without waiting for the
+//   answers (pipelining).
+//
+// Output:
+// - One answer line per query line, in the order the queries were sent on that connection,
+//   in the same format as "--stream". A client that closes its sending side still gets the
+//   answers to everything it sent, including a last line without '\n'.
+// - run returns after stop, once every connection has been closed.
+//
+// Comments:
+// - One thread runs an epoll loop that accepts connections and notices readable or
+//   writable sockets. A ready connection is handed to the worker pool, which reads what
+//   has arrived, answers all its complete lines as one batch through QueryProcessor, and
+//   writes as much of the answers as the socket takes. Connections are registered with
+//   EPOLLONESHOT and re-armed by the worker when it is done, so a connection is only ever
+//   on one worker at a time and its answers cannot be reordered.
+// - A client that sends queries faster than it reads answers stops being read once
+//   maxPendingOutput bytes of answers are waiting for it, and a line longer than
+//   maxLineBytes closes the connection, so one client cannot make the server grow without
+//   bound.
+// - Each batch pins the current dictionary version once, so a reload never splits a batch.
+// - Only Linux has epoll; elsewhere listenUnix, listenTcp and run report that and fail.
+//
+#ifndef QUERYSERVER_H
+#define QUERYSERVER_H
+
+#include "ConcurrentDictionary.h"
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+class QueryServer {
+public:
+    static constexpr std::size_t readBytes = std::size_t(64) << 10;        // Read from a socket in pieces of this size
+    static constexpr std::size_t maxLineBytes = std::size_t(1) << 20;      // Longest query line accepted
+    static constexpr std::size_t maxPendingOutput = std::size_t(4) << 20; // Answers buffered for one client before it stops being read
+
+    explicit QueryServer(const ConcurrentDictionary& dictionary) : dictionary(dictionary) {}
+    ~QueryServer();
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    bool listenUnix(const std::string& path); // The listenUnix function listens on a Unix domain socket, replacing a stale one at path.
+    bool listenTcp(unsigned short port);      // The listenTcp function listens on 127.0.0.1:port only.
+    bool run(unsigned workerCount);           // The run function serves clients until stop; false if nothing is listening.
+    void stop();                              // The stop function may be called from any thread or from a signal handler.
+    std::size_t queryCount() const { return queries.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection {
+        explicit Connection(int fd) : fd(fd) {}
+        int fd;
+        std::string input;       // Received bytes not answered yet (at most one partial line after a batch)
+        std::string output;      // Answers not written yet, from outputSent on
+        std::size_t outputSent = 0;
+        bool finished = false;   // The client closed its sending side
+    };
+
+    void serve(Connection* connection); // Runs on a worker while the connection is disarmed.
+    void answer(Connection& connection, bool flushPartialLine);
+    void rearmOrClose(Connection* connection);
+    void closeConnection(Connection* connection);
+    void acceptConnections();
+    bool listenOn(int fd);
+
+    const ConcurrentDictionary& dictionary;
+    int listenFd = -1;
+    int epollFd = -1;
+    int wakeFd = -1; // eventfd that stop writes to
+    std::string socketPath; // Removed again when the server is destroyed
+    std::atomic<bool> stopping{false};
+    std::atomic<std::size_t> queries{0};
+    std::mutex connectionsMutex;
+    std::unordered_set<Connection*> connections;
+};
+
+#endif // QUERYSERVER_H
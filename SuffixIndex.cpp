@@ -0,0 +1,66 @@
+// File: SuffixIndex.cpp
+// Summary:
+// This file implements the non-template parts of the SuffixIndex class: the reversed string
+// comparisons that define its order, and attaching to or detaching from borrowed storage.
+//
+// Input:
+// - Names and suffixes as string views, compared byte by byte from their last character.
+//
+// Output:
+// - Negative, zero or positive comparison results in the style of std::string::compare.
+//
+#include "SuffixIndex.h"
+
+void SuffixIndex::clear() {
+    positions.clear();
+    positions.shrink_to_fit();
+    external = nullptr;
+    externalSize = 0;
+    externalOwner.reset();
+}
+
+bool SuffixIndex::attach(const std::uint32_t* sorted, std::size_t count, std::shared_ptr<const void> owner) {
+    for (std::size_t i = 0; i < count; ++i) { // Every entry appears once, so every position is below count
+        if (sorted[i] >= count) {
+            return false;
+        }
+    }
+
+    clear();
+    external = sorted;
+    externalSize = count;
+    externalOwner = std::move(owner);
+    return true;
+}
+
+void SuffixIndex::detach() {
+    if (external == nullptr) {
+        return;
+    }
+    positions.assign(external, external + externalSize);
+    external = nullptr;
+    externalSize = 0;
+    externalOwner.reset();
+}
+
+int SuffixIndex::compareReversed(std::string_view a, std::string_view b) {
+    const std::size_t shared = std::min(a.size(), b.size());
+    for (std::size_t i = 1; i <= shared; ++i) {
+        const auto left = static_cast<unsigned char>(a[a.size() - i]);
+        const auto right = static_cast<unsigned char>(b[b.size() - i]);
+        if (left != right) {
+            return left < right ? -1 : 1;
+        }
+    }
+    if (a.size() == b.size()) {
+        return 0;
+    }
+    return a.size() < b.size() ? -1 : 1;
+}
+
+int SuffixIndex::compareSuffix(std::string_view name, std::string_view suffix) {
+    if (name.size() > suffix.size()) {
+        name.remove_prefix(name.size() - suffix.size()); // Only the last suffix.size() characters take part
+    }
+    return compareReversed(name, suffix);
+}
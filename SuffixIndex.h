@@ -0,0 +1,93 @@
+// File: SuffixIndex.h
+// Summary:
+// This file defines the SuffixIndex class, which keeps the positions of all dictionary
+// entries sorted by their reversed name. Every word that ends in a given suffix then sits in
+// one contiguous range, so a rhyme query is two binary searches instead of a full scan.
+//
+// Input:
+// - build and insert take entry positions and a callable returning the name at a position.
+// - equalRange takes the suffix to match; any suffix length can be used.
+//
+// Output:
+// - equalRange returns the range of positions (sorted by reversed name) whose names end in
+//   the suffix. The positions refer to the dictionary entries and nothing is copied.
+// - Like WordIndex, the sorted positions can be attached from a mapped snapshot and are
+//   copied into owned storage on the first insert.
+//
+#ifndef SUFFIXINDEX_H
+#define SUFFIXINDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class SuffixIndex {
+public:
+    using Range = std::pair<const std::uint32_t*, const std::uint32_t*>;
+
+    void clear(); // The clear function removes every entry and releases the table.
+    bool attach(const std::uint32_t* sorted, std::size_t count, std::shared_ptr<const void> owner); // Uses positions that are already sorted, without copying them; false if any is not below count.
+    void detach(); // The detach function copies an attached table into owned storage.
+
+    std::size_t size() const { return external ? externalSize : positions.size(); }
+    const std::uint32_t* data() const { return external ? external : positions.data(); }
+
+    template <typename NameAt>
+    void build(std::size_t entryCount, NameAt nameAt); // The build function indexes entries 0 to entryCount - 1.
+
+    template <typename NameAt>
+    void insert(std::uint32_t entry, NameAt nameAt); // The insert function adds one entry, keeping the order.
+
+    template <typename NameAt>
+    Range equalRange(std::string_view suffix, NameAt nameAt) const; // The equalRange function finds every entry whose name ends in suffix.
+
+    static int compareReversed(std::string_view a, std::string_view b); // Compares a and b as if both were reversed.
+    static int compareSuffix(std::string_view name, std::string_view suffix); // Compares the last suffix.size() characters of name, reversed, against the reversed suffix.
+
+private:
+    std::vector<std::uint32_t> positions;
+    const std::uint32_t* external = nullptr;
+    std::size_t externalSize = 0;
+    std::shared_ptr<const void> externalOwner;
+};
+
+template <typename NameAt>
+void SuffixIndex::build(std::size_t entryCount, NameAt nameAt) {
+    clear();
+    positions.resize(entryCount);
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        positions[i] = static_cast<std::uint32_t>(i);
+    }
+    std::stable_sort(positions.begin(), positions.end(), [&nameAt](std::uint32_t a, std::uint32_t b) {
+        return compareReversed(nameAt(a), nameAt(b)) < 0;
+    });
+}
+
+template <typename NameAt>
+void SuffixIndex::insert(std::uint32_t entry, NameAt nameAt) {
+    detach();
+    std::string_view name = nameAt(entry);
+    auto where = std::upper_bound(positions.begin(), positions.end(), name, [&nameAt](std::string_view key, std::uint32_t other) {
+        return compareReversed(key, nameAt(other)) < 0;
+    });
+    positions.insert(where, entry);
+}
+
+template <typename NameAt>
+SuffixIndex::Range SuffixIndex::equalRange(std::string_view suffix, NameAt nameAt) const {
+    const std::uint32_t* first = data();
+    const std::uint32_t* last = first + size();
+    first = std::lower_bound(first, last, suffix, [&nameAt](std::uint32_t entry, std::string_view key) {
+        return compareSuffix(nameAt(entry), key) < 0;
+    });
+    last = std::upper_bound(first, last, suffix, [&nameAt](std::string_view key, std::uint32_t entry) {
+        return compareSuffix(nameAt(entry), key) > 0;
+    });
+    return Range(first, last);
+}
+
+#endif // SUFFIXINDEX_H
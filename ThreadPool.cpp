@@ -0,0 +1,102 @@
+// File: ThreadPool.cpp
+// Summary:
+// This file implements the ThreadPool class: the worker loop, and parallelFor, which cuts
+// the items into one range per thread and waits for the ranges it queued.
+//
+// Input:
+// - Ranges are handed to whichever thread is free first, the caller included.
+//
+// Output:
+// - Every range has been processed when parallelFor returns.
+//
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(unsigned workerCount) {
+    workers.reserve(workerCount);
+    for (unsigned i = 0; i < workerCount; ++i) {
+        workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1); // The caller is the remaining thread
+    return pool;
+}
+
+void ThreadPool::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        taskReady.wait(lock, [this]() { return stopping || !tasks.empty(); });
+        if (tasks.empty()) {
+            return; // Stopping, and nothing is left to run
+        }
+        std::function<void()> task = std::move(tasks.front());
+        tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+        taskFinished.notify_all();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskReady.notify_one();
+}
+
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t begin, std::size_t end)>& body) {
+    const std::size_t ranges = std::min(count, workers.size() + 1);
+    if (ranges <= 1) {
+        if (count > 0) {
+            body(0, count);
+        }
+        return;
+    }
+
+    std::size_t remaining = ranges - 1; // Ranges queued for other threads, guarded by mutex
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (std::size_t r = 1; r < ranges; ++r) {
+            const std::size_t begin = count * r / ranges;
+            const std::size_t end = count * (r + 1) / ranges;
+            tasks.emplace_back([&body, &remaining, this, begin, end]() {
+                body(begin, end);
+                std::lock_guard<std::mutex> done(mutex);
+                --remaining;
+            });
+        }
+    }
+    taskReady.notify_all();
+
+    body(0, count / ranges);
+
+    // Help with queued tasks (ours or anyone's) until our own ranges are done
+    std::unique_lock<std::mutex> lock(mutex);
+    while (remaining > 0) {
+        if (!tasks.empty()) {
+            std::function<void()> task = std::move(tasks.front());
+            tasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            taskFinished.notify_all();
+        } else {
+            taskFinished.wait(lock);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+// File: ThreadPool.h
+// Summary:
+// This file defines the ThreadPool class, a fixed set of worker threads that share one
+// queue of tasks. It is used to spread bulk work, such as a batch of lookups, across cores
+// without starting new threads for every call.
+//
+// Input:
+// - parallelFor takes a number of items and a function that processes a range of them.
+// - submit takes a task to run on one of the workers.
+//
+// Output:
+// - parallelFor returns once every item has been processed. The calling thread works on
+//   the items as well, so a pool without workers simply runs everything on the caller, and
+//   calling parallelFor from inside a task cannot deadlock.
+// - submit returns at once; the task runs on a worker as soon as one is free. Tasks still
+//   queued when the pool is destroyed are run before the workers stop.
+// - shared returns one process wide pool with a worker per extra hardware thread.
+//
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned workerCount);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t workerCount() const { return workers.size(); }
+    void parallelFor(std::size_t count, const std::function<void(std::size_t begin, std::size_t end)>& body); // Runs body over [0, count) in ranges.
+    void submit(std::function<void()> task); // The submit function queues task for the workers; a pool without workers never runs it.
+
+    static ThreadPool& shared(); // The shared function returns the pool used by the dictionary's bulk operations.
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskReady;    // Signalled when a task is queued or the pool stops
+    std::condition_variable taskFinished; // Signalled whenever a task completes
+    bool stopping = false;
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,57 @@
+// File: Tokenizer.cpp
+// Summary:
+// This file implements Tokenizer::spaceMask, the classification step of the tokenizer. A
+// byte is whitespace when it is ' ' or lies between '\t' and '\r'; the range test is done
+// without signed compares as min(c - '\t', 4) == c - '\t'.
+//
+// Input:
+// - A block of at most 64 bytes.
+//
+// Output:
+// - A 64 bit mask of the whitespace bytes. Built with -mavx2 (or -march=native on a machine
+//   that has it) 32 bytes are classified per step, with SSE2 (every x86-64 target) 16 bytes,
+//   and on other targets one byte at a time. The result is the same either way.
+//
+#include "Tokenizer.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+std::uint64_t Tokenizer::spaceMask(const char* block, std::size_t length) {
+    std::uint64_t mask = 0;
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i blank32 = _mm256_set1_epi8(' ');
+    const __m256i tab32 = _mm256_set1_epi8('\t');
+    const __m256i controlRange32 = _mm256_set1_epi8('\r' - '\t');
+    for (; i + 32 <= length; i += 32) {
+        const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + i));
+        const __m256i fromTab = _mm256_sub_epi8(bytes, tab32);
+        const __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, blank32),
+                                              _mm256_cmpeq_epi8(_mm256_min_epu8(fromTab, controlRange32), fromTab));
+        mask |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm256_movemask_epi8(space))) << i;
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i blank16 = _mm_set1_epi8(' ');
+    const __m128i tab16 = _mm_set1_epi8('\t');
+    const __m128i controlRange16 = _mm_set1_epi8('\r' - '\t');
+    for (; i + 16 <= length; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + i));
+        const __m128i fromTab = _mm_sub_epi8(bytes, tab16);
+        const __m128i space = _mm_or_si128(_mm_cmpeq_epi8(bytes, blank16),
+                                           _mm_cmpeq_epi8(_mm_min_epu8(fromTab, controlRange16), fromTab));
+        mask |= static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_movemask_epi8(space))) << i;
+    }
+#endif
+    for (; i < length; ++i) {
+        if (isSpace(block[i])) {
+            mask |= std::uint64_t(1) << i;
+        }
+    }
+    if (length < 64) {
+        mask |= ~std::uint64_t(0) << length; // Bytes past the end act as whitespace, closing the last token
+    }
+    return mask;
+}
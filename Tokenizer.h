@@ -0,0 +1,118 @@
+// File: Tokenizer.h
+// Summary:
+// This file defines the Tokenizer class, which splits definition text into whitespace
+// separated words in place. It is shared by the Guess the Fourth Word question pool
+// (ClozeIndex) and the definition index, so both agree on what a word is.
+// The text is classified 64 bytes at a time into a bit mask of whitespace (with AVX2 or
+// SSE2 compares where the compiler targets them, a byte loop otherwise), and tokens are
+// read off the positions where the mask changes, so no byte is examined twice.
+//
+// Input:
+// - Text as a string view; it is never copied or modified.
+//
+// Output:
+// - forEach reports every token as a view into the text, in order, and never allocates.
+//   split is built on it, and count only counts the token starts in each mask. A token is
+//   a maximal run of characters that are not whitespace in the "C" locale (space, tab,
+//   newline, vertical tab, form feed, carriage return), which is exactly what reading with
+//   std::istringstream >> std::string produced.
+// - normalizeTerm turns a token into its search form: punctuation at either end is removed
+//   (letters, digits and bytes above 127 are kept), so "word," and "(word)" both give "word".
+//
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+class Tokenizer {
+public:
+    static bool isSpace(char c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+    template <typename OnToken>
+    static void forEach(std::string_view text, OnToken onToken); // The forEach function reports each token in text.
+
+    static std::size_t count(std::string_view text); // The count function returns the number of tokens in text.
+    static void split(std::string_view text, std::vector<std::string_view>& tokens); // Replaces tokens with the tokens of text.
+    static std::string_view normalizeTerm(std::string_view token); // Strips punctuation from both ends of a token.
+
+    static std::uint64_t spaceMask(const char* block, std::size_t length); // Bit i is set when block[i] is whitespace or i >= length (length <= 64).
+
+private:
+    static unsigned lowestBit(std::uint64_t bits); // Index of the lowest set bit, bits must not be 0
+};
+
+inline unsigned Tokenizer::lowestBit(std::uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#else
+    unsigned index = 0;
+    while ((bits & 1) == 0) {
+        bits >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
+template <typename OnToken>
+void Tokenizer::forEach(std::string_view text, OnToken onToken) {
+    std::size_t tokenStart = 0;
+    std::uint64_t previousSpace = 1; // Whether the byte before the block was whitespace, the start of text counts as whitespace
+    for (std::size_t block = 0; block < text.size(); block += 64) {
+        const std::size_t length = std::min<std::size_t>(64, text.size() - block);
+        const std::uint64_t space = spaceMask(text.data() + block, length);
+        std::uint64_t changes = space ^ ((space << 1) | previousSpace); // Set where a token starts or ends
+        while (changes != 0) {
+            const unsigned bit = lowestBit(changes);
+            changes &= changes - 1;
+            if ((space >> bit) & 1) {
+                onToken(text.substr(tokenStart, block + bit - tokenStart));
+            } else {
+                tokenStart = block + bit;
+            }
+        }
+        previousSpace = space >> 63;
+    }
+    if (previousSpace == 0) { // The text ends in a token that fills its last block to the end
+        onToken(text.substr(tokenStart));
+    }
+}
+
+inline std::size_t Tokenizer::count(std::string_view text) {
+    std::size_t tokens = 0;
+    std::uint64_t previousSpace = 1;
+    for (std::size_t block = 0; block < text.size(); block += 64) {
+        const std::size_t length = std::min<std::size_t>(64, text.size() - block);
+        const std::uint64_t space = spaceMask(text.data() + block, length);
+        tokens += std::bitset<64>(~space & ((space << 1) | previousSpace)).count(); // Token starts
+        previousSpace = space >> 63;
+    }
+    return tokens;
+}
+
+inline void Tokenizer::split(std::string_view text, std::vector<std::string_view>& tokens) {
+    tokens.clear();
+    forEach(text, [&tokens](std::string_view token) { tokens.push_back(token); });
+}
+
+inline std::string_view Tokenizer::normalizeTerm(std::string_view token) {
+    auto isWordByte = [](char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || static_cast<unsigned char>(c) >= 0x80;
+    };
+    std::size_t begin = 0;
+    std::size_t end = token.size();
+    while (begin < end && !isWordByte(token[begin])) {
+        ++begin;
+    }
+    while (end > begin && !isWordByte(token[end - 1])) {
+        --end;
+    }
+    return token.substr(begin, end - begin);
+}
+
+#endif // TOKENIZER_H
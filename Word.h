@@ -9,7 +9,11 @@
 //
 // Input:
 // The class takes input via its constructor parameters for initializing the word, type,
-// and definition. Setter methods allow modification of these attributes.
+// and definition. Setter methods allow modification of these attributes. The constructor and
+// setters copy from string views; assign copies a whole entry into the existing buffers.
+// The strings are std::pmr strings: the constructor's allocator argument places them in a
+// memory resource such as a dictionary's Arena, and words built without one use the heap.
+// Copying a word always gives heap strings, whatever the original used.
 //
 // Output:
 // The class provides output to the console through the printDefinition method,
@@ -19,31 +23,43 @@
 #ifndef WORD_H
 #define WORD_H
 
+#include "CaseFold.h"
 #include <iostream>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <algorithm>
 
-class Word { // The Word class uses std::string for storing the word, type, and definition.
+class Word { // The Word class uses std::pmr::string for storing the word, type, and definition.
 private:
-    std::string name;
-    std::string type;
-    std::string definition;
+    std::pmr::string name;
+    std::pmr::string type;
+    std::pmr::string definition;
 
 public:
-    explicit Word(std::string name = "", std::string type = "", std::string definition = "")
-            : name(std::move(name)), type(std::move(type)), definition(std::move(definition)) {}
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
 
-    std::string getName() const { return name; }
-    std::string getType() const { return type; }
-    std::string getDefinition() const { return definition; }
+    explicit Word(std::string_view name = {}, std::string_view type = {}, std::string_view definition = {}, const allocator_type& allocator = {})
+            : name(name, allocator), type(type, allocator), definition(definition, allocator) {}
 
-    void setName(const std::string& newName) { // Transformations are applied to the word's name to ensure uniformity (lowercase).
-        name = newName;
-        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    const std::pmr::string& getName() const { return name; } // Getters return references so lookups and scans can read without copying.
+    const std::pmr::string& getType() const { return type; }
+    const std::pmr::string& getDefinition() const { return definition; }
+
+    void setName(std::string_view newName) { // Transformations are applied to the word's name to ensure uniformity (lowercase).
+        name.assign(newName.data(), newName.size());
+        lowercaseName();
     }
 
-    void setType(const std::string& newType) { type = newType; }
-    void setDefinition(const std::string& newDefinition) { definition = newDefinition; }
+    void lowercaseName() { CaseFold::toLower(name.data(), name.size()); }
+    void setType(std::string_view newType) { type.assign(newType.data(), newType.size()); }
+    void setDefinition(std::string_view newDefinition) { definition.assign(newDefinition.data(), newDefinition.size()); }
+
+    void assign(std::string_view newName, std::string_view newType, std::string_view newDefinition) { // Copies an entry, reusing this word's buffers.
+        name.assign(newName.data(), newName.size());
+        type.assign(newType.data(), newType.size());
+        definition.assign(newDefinition.data(), newDefinition.size());
+    }
 
     void printDefinition() const { // The printDefinition method outputs the word details in a formatted manner.
         std::cout << "Word: " << name << "\n";
@@ -0,0 +1,107 @@
+// File: WordIndex.cpp
+// Summary:
+// This file implements the non-template parts of the WordIndex class: hashing, case
+// insensitive comparison and growing the open-addressing table.
+//
+// Input:
+// - Names are passed as string views and are never copied or modified.
+//
+// Output:
+// - The table doubles in size whenever the load factor would pass 0.7, rehashing
+//   from the cached hashes so the names are not read again.
+//
+#include "WordIndex.h"
+#include "CaseFold.h"
+#include <utility>
+
+void WordIndex::clear() {
+    slots.clear();
+    slots.shrink_to_fit();
+    external = nullptr;
+    externalSize = 0;
+    externalOwner.reset();
+    count = 0;
+}
+
+bool WordIndex::attach(const Slot* table, std::size_t tableSize, std::size_t entryCount, std::shared_ptr<const void> owner) {
+    if (tableSize == 0 || (tableSize & (tableSize - 1)) != 0) {
+        return false;
+    }
+    std::size_t used = 0;
+    for (std::size_t i = 0; i < tableSize; ++i) {
+        if (table[i].entry == npos) {
+            continue;
+        }
+        if (table[i].entry >= entryCount) {
+            return false;
+        }
+        ++used;
+    }
+    if (used == tableSize) { // find stops probing at an empty slot, so a full table would make it loop forever
+        return false;
+    }
+
+    clear();
+    external = table;
+    externalSize = tableSize;
+    externalOwner = std::move(owner);
+    count = used;
+    return true;
+}
+
+void WordIndex::detach() { // Copies a borrowed table into owned storage before it is modified
+    if (external == nullptr) {
+        return;
+    }
+    slots.assign(external, external + externalSize);
+    external = nullptr;
+    externalSize = 0;
+    externalOwner.reset();
+}
+
+void WordIndex::reserve(std::size_t expected) {
+    detach();
+    std::size_t capacity = 16;
+    while (capacity * 7 < expected * 10) {
+        capacity *= 2;
+    }
+    if (capacity <= slots.size()) {
+        return;
+    }
+
+    std::vector<Slot> old;
+    old.swap(slots);
+    slots.assign(capacity, Slot{npos, 0});
+    for (const Slot& slot : old) {
+        if (slot.entry != npos) {
+            place(slot);
+        }
+    }
+}
+
+void WordIndex::grow() {
+    reserve(slots.empty() ? 16 : slots.size());
+}
+
+void WordIndex::place(Slot slot) {
+    const std::size_t mask = slots.size() - 1;
+    std::size_t i = slot.hash & mask;
+    while (slots[i].entry != npos) {
+        i = (i + 1) & mask;
+    }
+    slots[i] = slot;
+}
+
+// - hash(std::string_view name): FNV-1a over the lowercased bytes, folded to 32 bits.
+std::uint32_t WordIndex::hash(std::string_view name) {
+    std::uint64_t h = 14695981039346656037ull;
+    for (char c : name) {
+        h ^= static_cast<unsigned char>(CaseFold::lower(c));
+        h *= 1099511628211ull;
+    }
+    return static_cast<std::uint32_t>(h ^ (h >> 32));
+}
+
+bool WordIndex::equalsIgnoreCase(std::string_view query, std::string_view stored) {
+    return CaseFold::equalsIgnoreCase(query, stored);
+}
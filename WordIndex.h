@@ -0,0 +1,114 @@
+// File: WordIndex.h
+// Summary:
+// This file defines the WordIndex class, an open-addressing hash table that maps the
+// lowercased name of a word to its position in the Dictionary's words vector. It lets
+// the Dictionary answer exact lookups in constant time instead of scanning every entry.
+//
+// Input:
+// - Entries are added with insert, which takes the position of the word and its name.
+// - Lookups take the word to search for; the query is lowercased on the fly while it is
+//   hashed and compared, so no temporary string is built.
+// - Both insert and find take a callable that returns the stored name for a position,
+//   the index itself only keeps positions and hashes.
+//
+// Output:
+// - find returns the position of the matching word, or WordIndex::npos if there is none.
+// - insert returns false if a word with the same lowercased name is already indexed, in
+//   which case the first entry is kept (matching the old linear search).
+// - The table can also be attached to slots that live elsewhere (a mapped snapshot file),
+//   together with a shared owner that keeps that memory alive; the first insert after
+//   attaching copies them into the index's own storage.
+//
+#ifndef WORDINDEX_H
+#define WORDINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+class WordIndex {
+public:
+    static constexpr std::uint32_t npos = 0xFFFFFFFFu;
+
+    struct Slot {
+        std::uint32_t entry; // Position in the words vector, npos when the slot is empty.
+        std::uint32_t hash;  // Cached hash so probing and rehashing never touch the names.
+    };
+
+    void clear(); // The clear function removes every entry and releases the table.
+    void reserve(std::size_t count); // The reserve function sizes the table so count entries fit without rehashing.
+    std::size_t size() const { return count; }
+    const Slot* slotData() const { return external ? external : slots.data(); }
+    std::size_t slotCount() const { return external ? externalSize : slots.size(); }
+    bool attach(const Slot* table, std::size_t tableSize, std::size_t entryCount, std::shared_ptr<const void> owner); // The attach function uses a prebuilt table without copying it; false unless tableSize is a power of two, every slot points below entryCount and at least one slot is empty.
+    void detach(); // The detach function copies an attached table into owned storage.
+
+    template <typename NameAt>
+    bool insert(std::uint32_t entry, std::string_view name, NameAt nameAt); // The insert function adds an entry unless its name is already indexed.
+
+    template <typename NameAt>
+    std::uint32_t find(std::string_view name, NameAt nameAt) const { return find(name, hash(name), nameAt); } // The find function returns the position of the word matching name.
+
+    template <typename NameAt>
+    std::uint32_t find(std::string_view name, std::uint32_t nameHash, NameAt nameAt) const; // Same as find, for a caller that already has hash(name).
+
+    static std::uint32_t hash(std::string_view name); // The hash function hashes the lowercased form of name.
+    static bool equalsIgnoreCase(std::string_view query, std::string_view stored); // Compares two names as if both were lowercased.
+
+private:
+    void grow();
+    void place(Slot slot);
+
+    std::vector<Slot> slots;
+    const Slot* external = nullptr; // Borrowed table, kept alive by externalOwner
+    std::size_t externalSize = 0;
+    std::shared_ptr<const void> externalOwner;
+    std::size_t count = 0;
+};
+
+template <typename NameAt>
+bool WordIndex::insert(std::uint32_t entry, std::string_view name, NameAt nameAt) {
+    detach();
+    if (slots.empty() || (count + 1) * 10 > slots.size() * 7) { // Keep the load factor under 0.7
+        grow();
+    }
+
+    const std::uint32_t h = hash(name);
+    const std::size_t mask = slots.size() - 1;
+    for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+        Slot& slot = slots[i];
+        if (slot.entry == npos) {
+            slot = Slot{entry, h};
+            ++count;
+            return true;
+        }
+        if (slot.hash == h && equalsIgnoreCase(name, nameAt(slot.entry))) {
+            return false;
+        }
+    }
+}
+
+template <typename NameAt>
+std::uint32_t WordIndex::find(std::string_view name, std::uint32_t nameHash, NameAt nameAt) const {
+    const Slot* table = slotData();
+    const std::size_t tableSize = slotCount();
+    if (tableSize == 0) {
+        return npos;
+    }
+
+    const std::uint32_t h = nameHash;
+    const std::size_t mask = tableSize - 1;
+    for (std::size_t i = h & mask;; i = (i + 1) & mask) {
+        const Slot& slot = table[i];
+        if (slot.entry == npos) {
+            return npos;
+        }
+        if (slot.hash == h && equalsIgnoreCase(name, nameAt(slot.entry))) {
+            return slot.entry;
+        }
+    }
+}
+
+#endif // WORDINDEX_H
@@ -0,0 +1,254 @@
+// File: WordStore.cpp
+// Summary:
+// This file implements the WordStore class: appending entries to the column arrays,
+// interning word types into one byte codes, and moving the columns in and out of snapshots.
+//
+// Input:
+// - Entry fields as string views, and mapped snapshot sections.
+//
+// Output:
+// - Column arrays that grow geometrically, so loading N entries costs a handful of large
+//   allocations instead of up to three small ones per entry.
+//
+#include "WordStore.h"
+#include "CaseFold.h"
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+const char* const builtInTypes[] = {"", "n", "v", "adj", "Noun", "Verb", "Adjective", "Unknown"};
+
+} // namespace
+
+WordStore::WordStore() {
+    clear();
+}
+
+void WordStore::clear() {
+    nameChars = WordStoreColumn<char>();
+    nameOffsets = WordStoreColumn<std::uint64_t>();
+    packedDefinitions.clear();
+    definitionChars = WordStoreColumn<char>();
+    definitionOffsets = WordStoreColumn<std::uint64_t>();
+    types = WordStoreColumn<std::uint8_t>();
+    externalOwner.reset();
+
+    nameOffsets.values().push_back(0);
+    definitionOffsets.values().push_back(0);
+    typeNames.assign(std::begin(builtInTypes), std::end(builtInTypes));
+}
+
+void WordStore::reserve(std::size_t entryCount, std::size_t nameBytes, std::size_t definitionBytes) {
+    nameChars.values().reserve(nameBytes);
+    nameOffsets.values().reserve(entryCount + 1);
+    definitionChars.values().reserve(definitionBytes);
+    definitionOffsets.values().reserve(entryCount + 1);
+    types.values().reserve(entryCount);
+}
+
+void WordStore::shrinkToFit() {
+    nameChars.shrinkToFit();
+    nameOffsets.shrinkToFit();
+    definitionChars.shrinkToFit();
+    definitionOffsets.shrinkToFit();
+    types.shrinkToFit();
+}
+
+bool WordStore::internType(std::string_view type, std::uint8_t& code) {
+    for (std::size_t i = 0; i < typeNames.size(); ++i) { // Only a handful of types exist, a linear scan beats hashing
+        if (typeNames[i] == type) {
+            code = static_cast<std::uint8_t>(i);
+            return true;
+        }
+    }
+    if (typeNames.size() > 0xFF) {
+        return false;
+    }
+    code = static_cast<std::uint8_t>(typeNames.size());
+    typeNames.emplace_back(type);
+    return true;
+}
+
+bool WordStore::append(std::string_view name, std::string_view type, std::string_view definition, bool lowercaseName) {
+    std::uint8_t code;
+    if (!internType(type, code)) {
+        return false;
+    }
+
+    std::vector<char>& names = nameChars.values();
+    const std::size_t nameStart = names.size();
+    names.insert(names.end(), name.begin(), name.end());
+    if (lowercaseName) {
+        CaseFold::toLower(names.data() + nameStart, name.size());
+    }
+    nameOffsets.values().push_back(names.size());
+
+    std::vector<char>& definitions = definitionChars.values();
+    definitions.insert(definitions.end(), definition.begin(), definition.end());
+    definitionOffsets.values().push_back(packedDefinitions.size() + definitions.size());
+
+    types.values().push_back(code);
+    return true;
+}
+
+bool WordStore::appendStore(const WordStore& other) {
+    if (other.definitionsCompressed()) { // Its arena holds only part of its definitions
+        for (std::size_t i = 0; i < other.size(); ++i) {
+            if (!append(other.name(i), other.type(i), other.definition(i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+    std::vector<std::uint8_t> codes(other.typeNames.size()); // other's type codes, translated into this store's
+    for (std::size_t i = 0; i < other.typeNames.size(); ++i) {
+        if (!internType(other.typeNames[i], codes[i])) {
+            return false;
+        }
+    }
+
+    const std::size_t count = other.size();
+    std::vector<char>& names = nameChars.values();
+    std::vector<std::uint64_t>& nameStarts = nameOffsets.values();
+    const std::uint64_t nameBase = names.size();
+    names.insert(names.end(), other.nameChars.data(), other.nameChars.data() + other.nameChars.size());
+    for (std::size_t i = 1; i <= count; ++i) {
+        nameStarts.push_back(nameBase + other.nameOffsets[i]);
+    }
+
+    std::vector<char>& definitions = definitionChars.values();
+    std::vector<std::uint64_t>& definitionStarts = definitionOffsets.values();
+    const std::uint64_t definitionBase = packedDefinitions.size() + definitions.size();
+    definitions.insert(definitions.end(), other.definitionChars.data(), other.definitionChars.data() + other.definitionChars.size());
+    for (std::size_t i = 1; i <= count; ++i) {
+        definitionStarts.push_back(definitionBase + other.definitionOffsets[i]);
+    }
+
+    std::vector<std::uint8_t>& typeCodes = types.values();
+    for (std::size_t i = 0; i < count; ++i) {
+        typeCodes.push_back(codes[other.types[i]]);
+    }
+    return true;
+}
+
+// - compressDefinitions(): The entries whose definitions start in the arena are handed to
+//   packedDefinitions with their ends, then the arena is released.
+void WordStore::compressDefinitions() {
+    const std::uint64_t packedBytes = packedDefinitions.size();
+    const std::uint64_t* starts = definitionOffsets.data();
+    const std::size_t first = static_cast<std::size_t>(std::lower_bound(starts, starts + size(), packedBytes) - starts);
+    if (first == size() || definitionChars.size() == 0) {
+        return;
+    }
+    std::vector<std::uint64_t> ends(size() - first);
+    for (std::size_t i = first; i < size(); ++i) {
+        ends[i - first] = definitionOffsets[i + 1] - packedBytes;
+    }
+    packedDefinitions.append(std::string_view(definitionChars.data(), definitionChars.size()), ends.data(), ends.size());
+    definitionChars = WordStoreColumn<char>();
+}
+
+bool WordStore::decompressDefinitions() {
+    if (!definitionsCompressed()) {
+        return true;
+    }
+    std::vector<char> definitions;
+    definitions.reserve(static_cast<std::size_t>(packedDefinitions.size()) + definitionChars.size());
+    if (!packedDefinitions.unpack(definitions)) {
+        return false;
+    }
+    definitions.insert(definitions.end(), definitionChars.data(), definitionChars.data() + definitionChars.size());
+    packedDefinitions.clear();
+    definitionChars = WordStoreColumn<char>();
+    definitionChars.values().swap(definitions);
+    return true;
+}
+
+std::size_t WordStore::memoryUsage() const {
+    std::size_t bytes = nameChars.memoryUsage() + nameOffsets.memoryUsage() + packedDefinitions.memoryUsage() + definitionChars.memoryUsage()
+                        + definitionOffsets.memoryUsage() + types.memoryUsage();
+    for (const auto& typeName : typeNames) {
+        bytes += sizeof(typeName) + (typeName.capacity() > 15 ? typeName.capacity() + 1 : 0);
+    }
+    return bytes;
+}
+
+void WordStore::addSections(DictionarySnapshot::Builder& builder) const {
+    using Section = DictionarySnapshot::Section;
+    builder.addSection(Section::NameChars, nameChars.data(), nameChars.size(), nameChars.size());
+    builder.addSection(Section::NameOffsets, nameOffsets.data(), nameOffsets.size() * sizeof(std::uint64_t), nameOffsets.size());
+    if (definitionsCompressed()) { // Snapshots hold plain text, which the mapping pages in on demand anyway
+        std::vector<char> definitions;
+        packedDefinitions.unpack(definitions);
+        definitions.insert(definitions.end(), definitionChars.data(), definitionChars.data() + definitionChars.size());
+        builder.addSection(Section::DefinitionChars, definitions.data(), definitions.size(), definitions.size());
+    } else {
+        builder.addSection(Section::DefinitionChars, definitionChars.data(), definitionChars.size(), definitionChars.size());
+    }
+    builder.addSection(Section::DefinitionOffsets, definitionOffsets.data(),
+                       definitionOffsets.size() * sizeof(std::uint64_t), definitionOffsets.size());
+    builder.addSection(Section::Types, types.data(), types.size(), types.size());
+
+    std::string joined; // Type spellings never contain '\0' or newlines, so they are stored '\0' separated
+    for (const auto& typeName : typeNames) {
+        joined += typeName;
+        joined += '\0';
+    }
+    builder.addSection(Section::TypeNames, joined.data(), joined.size(), typeNames.size());
+}
+
+bool WordStore::attachSections(const DictionarySnapshot& snapshot, std::shared_ptr<const void> owner) {
+    using Section = DictionarySnapshot::Section;
+    DictionarySnapshot::SectionData names, nameStarts, definitions, definitionStarts, typeCodes, typeSpellings;
+    if (!snapshot.section(Section::NameChars, names) || !snapshot.section(Section::NameOffsets, nameStarts)
+        || !snapshot.section(Section::DefinitionChars, definitions) || !snapshot.section(Section::DefinitionOffsets, definitionStarts)
+        || !snapshot.section(Section::Types, typeCodes) || !snapshot.section(Section::TypeNames, typeSpellings)) {
+        return false;
+    }
+
+    const std::size_t entryCount = snapshot.size();
+    const auto* nameOffsetData = static_cast<const std::uint64_t*>(nameStarts.data);
+    const auto* definitionOffsetData = static_cast<const std::uint64_t*>(definitionStarts.data);
+    if (typeCodes.count != entryCount || typeCodes.size != typeCodes.count || nameStarts.count != entryCount + 1 || definitionStarts.count != entryCount + 1
+        || nameStarts.size != nameStarts.count * sizeof(std::uint64_t)
+        || definitionStarts.size != definitionStarts.count * sizeof(std::uint64_t)
+        || nameOffsetData[entryCount] != names.size || definitionOffsetData[entryCount] != definitions.size) {
+        return false;
+    }
+
+    std::vector<std::string> spellings;
+    const char* spelling = static_cast<const char*>(typeSpellings.data);
+    const char* spellingsEnd = spelling + typeSpellings.size;
+    while (spelling < spellingsEnd) {
+        const char* terminator = static_cast<const char*>(std::memchr(spelling, '\0', static_cast<std::size_t>(spellingsEnd - spelling)));
+        if (terminator == nullptr) {
+            return false;
+        }
+        spellings.emplace_back(spelling, terminator);
+        spelling = terminator + 1;
+    }
+    if (spellings.size() != typeSpellings.count || spellings.size() > 0x100) {
+        return false;
+    }
+
+    // Every entry is read without bounds checks later, so a corrupt column is caught here, once
+    const auto* typeCodeData = static_cast<const std::uint8_t*>(typeCodes.data);
+    for (std::size_t i = 0; i < entryCount; ++i) {
+        if (nameOffsetData[i] > nameOffsetData[i + 1] || definitionOffsetData[i] > definitionOffsetData[i + 1]
+            || typeCodeData[i] >= spellings.size()) {
+            return false;
+        }
+    }
+
+    packedDefinitions.clear();
+    nameChars.attach(static_cast<const char*>(names.data), names.size);
+    nameOffsets.attach(nameOffsetData, nameStarts.count);
+    definitionChars.attach(static_cast<const char*>(definitions.data), definitions.size);
+    definitionOffsets.attach(definitionOffsetData, definitionStarts.count);
+    types.attach(typeCodeData, typeCodes.count);
+    typeNames.swap(spellings);
+    externalOwner = std::move(owner);
+    return true;
+}
@@ -0,0 +1,135 @@
+// File: WordStore.h
+// Summary:
+// This file defines the WordStore class, the compact storage backend for dictionary entries.
+// Instead of one Word object with three std::strings per entry, it keeps column arrays:
+// all names back to back in one character arena, all definitions in a second arena, an
+// offset array for each arena, and a one byte type code per entry. A name-only scan
+// (palindromes, rhymes, index builds) only touches the name arena and its offsets.
+//
+// Input:
+// - append takes the name, type and definition of one entry as string views and copies
+//   them into the arenas.
+// - attachSections takes a mapped DictionarySnapshot whose columns are used in place.
+//
+// Output:
+// - name, type and definition return views into the arenas, valid until the store is
+//   modified or destroyed.
+// - memoryUsage returns the bytes held by the columns, for comparison with std::vector<Word>.
+// - A store attached to a snapshot is copied into owned columns on the first append.
+// - appendStore concatenates another store (for example one filled by a parser thread),
+//   rebasing its offsets and re-interning its type codes.
+// - compressDefinitions moves the definitions into a CompressedText, leaving names, types and
+//   every offset as they are; decompressDefinitions brings them back into the arena. In a
+//   compressed store, definition returns a view into a decompressed block (see
+//   CompressedText::view for how long it stays valid), and definitions appended later stay
+//   uncompressed in the arena until compressDefinitions runs again.
+//
+#ifndef WORDSTORE_H
+#define WORDSTORE_H
+
+#include "CompressedText.h"
+#include "DictionarySnapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+template <typename T>
+class WordStoreColumn { // One column of the store, either owned or borrowed from a mapped snapshot.
+public:
+    const T* data() const { return external ? external : owned.data(); }
+    std::size_t size() const { return external ? externalSize : owned.size(); }
+    const T& operator[](std::size_t i) const { return data()[i]; }
+    std::size_t memoryUsage() const { return owned.capacity() * sizeof(T); }
+    void shrinkToFit() { owned.shrink_to_fit(); }
+
+    void attach(const T* values, std::size_t count) {
+        owned.clear();
+        owned.shrink_to_fit();
+        external = values;
+        externalSize = count;
+    }
+
+    std::vector<T>& values() { // Owned values for appending, copying a borrowed column first
+        if (external) {
+            owned.assign(external, external + externalSize);
+            external = nullptr;
+            externalSize = 0;
+        }
+        return owned;
+    }
+
+private:
+    std::vector<T> owned;
+    const T* external = nullptr;
+    std::size_t externalSize = 0;
+};
+
+class WordStore {
+public:
+    enum class WordType : std::uint8_t { // Spellings found in dictionary files or produced by typeConversion
+        Empty,          // ""
+        NounCode,       // "n"
+        VerbCode,       // "v"
+        AdjectiveCode,  // "adj"
+        Noun,           // "Noun"
+        Verb,           // "Verb"
+        Adjective,      // "Adjective"
+        Unknown,        // "Unknown"
+        FirstCustom,    // Any other spelling is interned after the built-in ones
+    };
+
+    WordStore();
+
+    void clear(); // The clear function removes every entry.
+    void reserve(std::size_t entryCount, std::size_t nameBytes, std::size_t definitionBytes);
+    void shrinkToFit(); // The shrinkToFit function releases the spare capacity left after a bulk load.
+    bool append(std::string_view name, std::string_view type, std::string_view definition, bool lowercaseName = false); // Returns False once 256 distinct types are in use.
+    bool appendStore(const WordStore& other); // Appends every entry of other in order, copying whole columns at once.
+    void compressDefinitions(); // Compresses the definitions still held in the arena.
+    bool decompressDefinitions(); // Moves every definition back into the arena.
+    bool definitionsCompressed() const { return packedDefinitions.size() != 0; }
+
+    std::size_t size() const { return types.size(); }
+    std::string_view name(std::size_t position) const;
+    std::string_view definition(std::size_t position) const;
+    std::size_t definitionSize(std::size_t position) const { return static_cast<std::size_t>(definitionOffsets[position + 1] - definitionOffsets[position]); } // Read from the offsets, so no block is decompressed.
+    std::string_view type(std::size_t position) const { return typeNames[types[position]]; }
+    WordType typeCode(std::size_t position) const { return static_cast<WordType>(types[position]); }
+
+    std::size_t memoryUsage() const; // The memoryUsage function returns the bytes allocated for the columns.
+
+    void addSections(DictionarySnapshot::Builder& builder) const; // Stores every column as a snapshot section.
+    bool attachSections(const DictionarySnapshot& snapshot, std::shared_ptr<const void> owner); // Uses the columns of a mapped snapshot in place; false if any offset or type code is out of range.
+
+private:
+    bool internType(std::string_view type, std::uint8_t& code);
+
+    WordStoreColumn<char> nameChars;
+    WordStoreColumn<std::uint64_t> nameOffsets;       // size() + 1 entries, name i is [nameOffsets[i], nameOffsets[i + 1])
+    CompressedText packedDefinitions;                 // Definition text [0, packedDefinitions.size()), when compressed
+    WordStoreColumn<char> definitionChars;            // The rest of the definition text
+    WordStoreColumn<std::uint64_t> definitionOffsets; // size() + 1 entries, like nameOffsets, counting packed text too
+    WordStoreColumn<std::uint8_t> types;
+    std::vector<std::string> typeNames;
+    std::shared_ptr<const void> externalOwner; // Keeps borrowed columns alive
+};
+
+inline std::string_view WordStore::name(std::size_t position) const {
+    const std::uint64_t begin = nameOffsets[position];
+    return std::string_view(nameChars.data() + begin, static_cast<std::size_t>(nameOffsets[position + 1] - begin));
+}
+
+inline std::string_view WordStore::definition(std::size_t position) const {
+    const std::uint64_t begin = definitionOffsets[position];
+    const auto length = static_cast<std::size_t>(definitionOffsets[position + 1] - begin);
+    const std::uint64_t packedBytes = packedDefinitions.size();
+    if (begin < packedBytes) {
+        return packedDefinitions.view(begin, length);
+    }
+    return std::string_view(definitionChars.data() + (begin - packedBytes), length);
+}
+
+#endif // WORDSTORE_H
@@ -0,0 +1,62 @@
+// File: AllocationBenchmark.cpp
+// Summary:
+// This program counts the heap allocations made by each dictionary operation: loading a
+// file, exact searches that hit and miss, rhyme queries, palindrome listings and saving.
+// It is used to check that hot paths read entries without copying them.
+//
+// Input:
+// - The dictionary file to load, given as the only command line argument.
+//
+// Output:
+// - One line per operation with the average number of allocations and bytes requested.
+//
+#include "../ImprovedDictionary.h"
+#include "AllocationCounter.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+template <typename Operation>
+void report(const char* label, std::size_t repetitions, Operation operation) {
+    const AllocationStats before = allocationStats();
+    for (std::size_t i = 0; i < repetitions; ++i) {
+        operation(i);
+    }
+    const AllocationStats used = allocationStats() - before;
+    std::cout << label << ": " << static_cast<double>(used.allocations) / repetitions << " allocations, "
+              << static_cast<double>(used.bytes) / repetitions << " bytes per call\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <dictionary.txt>\n";
+        return 1;
+    }
+
+    ImprovedDictionary dictionary;
+    report("loadDictionaryFromFile", 1, [&](std::size_t) { dictionary.loadDictionaryFromFile(argv[1]); });
+    if (dictionary.wordCount() == 0) {
+        std::cerr << "No words loaded from " << argv[1] << "\n";
+        return 1;
+    }
+
+    const std::size_t queries = std::min<std::size_t>(dictionary.wordCount(), 10000);
+    std::vector<std::string> hits, misses;
+    for (std::size_t i = 0; i < queries; ++i) {
+        hits.emplace_back(dictionary.nameAt(i * (dictionary.wordCount() / queries)));
+        misses.push_back(hits.back() + "#");
+    }
+
+    Word located;
+    report("searchWordInDictionary (hit)", queries, [&](std::size_t i) { dictionary.searchWordInDictionary(hits[i], located); });
+    report("searchWordInDictionary (miss)", queries, [&](std::size_t i) { dictionary.searchWordInDictionary(misses[i], located); });
+    report("findRhymingWords", queries, [&](std::size_t i) { dictionary.findRhymingWords(hits[i]); });
+    report("findPalindromes A-Z", 100, [&](std::size_t) { dictionary.findPalindromes('A', 'Z'); });
+    report("saveDictionaryToFile", 1, [&](std::size_t) { dictionary.saveDictionaryToFile("allocation_benchmark_output.txt"); });
+    std::remove("allocation_benchmark_output.txt");
+    return 0;
+}
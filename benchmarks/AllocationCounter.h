@@ -0,0 +1,69 @@
+// File: AllocationCounter.h
+// Summary:
+// This header replaces the global operator new and operator delete for a benchmark program
+// so it can count heap allocations and the bytes they request. Include it from exactly one
+// translation unit of each benchmark executable.
+//
+// Input:
+// - None, every allocation made by the program is counted.
+//
+// Output:
+// - allocationStats returns the totals so far. Take one reading before and one after the
+//   operation being measured and subtract them.
+//
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+struct AllocationStats {
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+
+    AllocationStats operator-(const AllocationStats& earlier) const {
+        return AllocationStats{allocations - earlier.allocations, bytes - earlier.bytes};
+    }
+};
+
+namespace allocation_counter {
+inline std::atomic<std::size_t> allocations{0};
+inline std::atomic<std::size_t> bytes{0};
+} // namespace allocation_counter
+
+inline AllocationStats allocationStats() {
+    return AllocationStats{allocation_counter::allocations.load(), allocation_counter::bytes.load()};
+}
+
+void* operator new(std::size_t size) {
+    allocation_counter::allocations.fetch_add(1, std::memory_order_relaxed);
+    allocation_counter::bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,80 @@
+// File: CaseFoldBenchmark.cpp
+// Summary:
+// This program measures the CaseFold kernels against the byte at a time loops they replaced:
+// lowercasing every name (std::transform with ::tolower against CaseFold::toLower),
+// comparing every name with an uppercased copy of itself, and checking every name for a
+// palindrome. Build it once as usual (SSE2) and once with -mavx2 to compare the two
+// instruction sets.
+//
+// Input:
+// - The dictionary file to load, given as the only command line argument.
+//
+// Output:
+// - One line per method with the time per pass over all names and the throughput in MB/s.
+//
+#include "../Dictionary.h"
+#include "../CaseFold.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+template <typename Pass>
+void measure(const char* label, std::size_t count, std::size_t bytes, Pass pass) {
+    const int repetitions = 5;
+    std::size_t matches = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        matches = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            matches += pass(i);
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repetitions;
+    std::cout << label << ": " << matches << " matches, " << seconds * 1000 << " ms per pass, "
+              << bytes / seconds / 1e6 << " MB/s\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <dictionary.txt>\n";
+        return 1;
+    }
+
+    Dictionary dictionary;
+    dictionary.setStorageMode(StorageMode::Compact);
+    if (!dictionary.loadFile(argv[1])) {
+        return 1;
+    }
+    const std::size_t count = dictionary.wordCount();
+    std::size_t bytes = 0;
+    std::vector<std::string> upper(count); // Every name uppercased, the worst case for folding
+    for (std::size_t i = 0; i < count; ++i) {
+        upper[i] = dictionary.nameAt(i);
+        std::transform(upper[i].begin(), upper[i].end(), upper[i].begin(), ::toupper);
+        bytes += upper[i].size();
+    }
+
+    std::string folded;
+    measure("std::transform ::tolower", count, bytes, [&](std::size_t i) {
+        folded.assign(upper[i]);
+        std::transform(folded.begin(), folded.end(), folded.begin(), ::tolower);
+        return folded.size() == dictionary.nameAt(i).size();
+    });
+    measure("CaseFold::toLower", count, bytes, [&](std::size_t i) {
+        folded.assign(upper[i]);
+        CaseFold::toLower(folded.data(), folded.size());
+        return folded.size() == dictionary.nameAt(i).size();
+    });
+    measure("equalsIgnoreCase (scalar)", count, bytes,
+            [&](std::size_t i) { return CaseFold::equalsIgnoreCaseScalar(upper[i], dictionary.nameAt(i)); });
+    measure("CaseFold::equalsIgnoreCase", count, bytes,
+            [&](std::size_t i) { return CaseFold::equalsIgnoreCase(upper[i], dictionary.nameAt(i)); });
+    measure("isPalindrome (scalar)", count, bytes, [&](std::size_t i) { return CaseFold::isPalindromeScalar(upper[i]); });
+    measure("CaseFold::isPalindrome", count, bytes, [&](std::size_t i) { return CaseFold::isPalindrome(upper[i]); });
+    return 0;
+}
@@ -0,0 +1,79 @@
+// File: ConcurrentReadBenchmark.cpp
+// Summary:
+// This program measures how read throughput of a ConcurrentDictionary scales with the
+// number of reader threads. Each reader pins a version and runs an exact search and a rhyme
+// query on it, while a writer thread adds a new word every millisecond.
+//
+// Input:
+// - The dictionary file to load, given as the only command line argument.
+//
+// Output:
+// - One line per reader count with the reads per second, the speedup over one reader and
+//   the number of words added meanwhile.
+//
+#include "../ConcurrentDictionary.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <dictionary.txt>\n";
+        return 1;
+    }
+
+    ImprovedDictionary loaded;
+    if (!loaded.loadDictionaryFromFile(argv[1]) || loaded.wordCount() == 0) {
+        std::cerr << "No words loaded from " << argv[1] << "\n";
+        return 1;
+    }
+    ConcurrentDictionary dictionary(loaded);
+    const std::size_t baseCount = loaded.wordCount();
+    const unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::size_t added = 0;
+    double singleThreaded = 0;
+
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+        std::atomic<bool> stop{false};
+        std::atomic<std::size_t> reads{0};
+        std::vector<std::thread> readers;
+        for (unsigned t = 0; t < threads; ++t) {
+            readers.emplace_back([&dictionary, &stop, &reads, baseCount, t]() {
+                std::size_t local = 0;
+                Word located;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    ConcurrentDictionary::Reader reader = dictionary.read();
+                    const std::string name(reader->nameAt((local * 7919 + t * 104729) % baseCount));
+                    reader->searchWordInDictionary(name, located);
+                    reader->findRhymingWords(name);
+                    ++local;
+                }
+                reads += local;
+            });
+        }
+
+        const std::size_t addedBefore = added;
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < std::chrono::seconds(1)) {
+            dictionary.addWord(Word("benchmarkword" + std::to_string(added++), "n", "added while reading"));
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const double perSecond = reads / seconds;
+        if (threads == 1) {
+            singleThreaded = perSecond;
+        }
+        std::cout << threads << " readers: " << static_cast<std::size_t>(perSecond) << " reads/s, "
+                  << perSecond / singleThreaded << "x, " << added - addedBefore << " words added\n";
+    }
+    return 0;
+}
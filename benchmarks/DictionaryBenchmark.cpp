@@ -0,0 +1,190 @@
+// File: DictionaryBenchmark.cpp
+// Summary:
+// This program is the baseline benchmark for the dictionary: it times loading, exact
+// search, rhyme and palindrome queries, game questions and saving on one dictionary file,
+// so every change can be compared against the same numbers. Use GenerateDictionary to make files of any size.
+//
+// Input:
+// - The dictionary file and an optional number of queries per query benchmark
+//   (default 100000).
+//
+// Output:
+// - One line per operation on standard output: how often it ran, its throughput, its
+//   latency percentiles and the peak resident set size of the process after it ran.
+//
+// Comments:
+// - "loadFile" is the plain Dictionary parse; "loadDictionaryFromFile" adds the
+//   ImprovedDictionary indexes and is what the program runs. Each load and save runs
+//   repeatCount times and is reported per run, in MiB/s of the file.
+// - Searches use names sampled from the file (hits) and the same names with a letter added
+//   (misses), in equal parts. Rhyme queries use sampled names. The palindrome benchmark
+//   runs findPalindromes over the nine letter ranges of the palindrome menu, which is the
+//   query behind listPalindromesRange without its printing. pickClozeQuestion draws as
+//   many guessing game questions as there are searches.
+// - Every operation is timed on its own, so the percentiles include the clock overhead
+//   (tens of nanoseconds), which matters only for the fastest searches.
+// - Peak RSS comes from getrusage and only ever grows, so each line shows the high water
+//   mark of everything before it, and a line is only attributable to its operation when
+//   the figure rises there.
+//
+#include "../ImprovedDictionary.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+const int repeatCount = 3;
+
+double peakRssMiB() {
+#ifdef _WIN32
+    return 0.0;
+#else
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // Bytes on macOS
+#else
+    return usage.ru_maxrss / 1024.0; // KiB on Linux
+#endif
+#endif
+}
+
+double fileMiB(const std::string& filename) {
+    struct stat info;
+    return stat(filename.c_str(), &info) == 0 ? info.st_size / (1024.0 * 1024.0) : 0.0;
+}
+
+// Collects one latency per operation and prints the summary line for them
+class Timings {
+public:
+    template <typename Operation>
+    void time(Operation&& operation) {
+        const auto start = std::chrono::steady_clock::now();
+        operation();
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // unitsPerRun turns runs per second into units per second, e.g. MiB per load
+    void report(const char* label, double unitsPerRun = 1.0, const char* unit = "ops") {
+        std::sort(latencies.begin(), latencies.end());
+        double total = 0;
+        for (double latency : latencies) {
+            total += latency;
+        }
+        std::cout << std::left << std::setw(24) << label << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(9) << latencies.size() << " runs"
+                  << std::setw(14) << (total > 0 ? latencies.size() * unitsPerRun / (total / 1e6) : 0.0) << " " << unit << "/s"
+                  << "  p50 " << percentile(0.50) << "  p90 " << percentile(0.90) << "  p99 " << percentile(0.99)
+                  << "  p99.9 " << percentile(0.999) << "  max " << (latencies.empty() ? 0.0 : latencies.back()) << " us"
+                  << "  peak RSS " << peakRssMiB() << " MiB\n";
+        latencies.clear();
+    }
+
+private:
+    double percentile(double fraction) const {
+        if (latencies.empty()) {
+            return 0.0;
+        }
+        return latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(fraction * latencies.size()))];
+    }
+
+    std::vector<double> latencies; // Microseconds
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <dictionary.txt> [queries]\n";
+        return 1;
+    }
+    const std::string filename = argv[1];
+    const std::size_t queryCount = argc == 3 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+    const double megabytes = fileMiB(filename);
+    Timings timings;
+
+    for (int run = 0; run < repeatCount; ++run) {
+        ImprovedDictionary parsed;
+        bool loaded = false;
+        timings.time([&]() { loaded = parsed.loadFile(filename); });
+        if (!loaded) {
+            std::cerr << "Cannot load " << filename << "\n";
+            return 1;
+        }
+    }
+    timings.report("loadFile", megabytes, "MiB");
+
+    ImprovedDictionary dictionary;
+    for (int run = 0; run < repeatCount; ++run) {
+        timings.time([&]() { dictionary.loadDictionaryFromFile(filename); });
+    }
+    timings.report("loadDictionaryFromFile", megabytes, "MiB");
+    if (dictionary.wordCount() == 0) {
+        std::cerr << "No words loaded from " << filename << "\n";
+        return 1;
+    }
+    std::cout << dictionary.wordCount() << " entries, " << std::setprecision(1) << megabytes << " MiB\n";
+
+    std::mt19937_64 random(42);
+    std::uniform_int_distribution<std::size_t> entry(0, dictionary.wordCount() - 1);
+    std::vector<std::string> queries;
+    for (std::size_t i = 0; i < queryCount; ++i) {
+        queries.emplace_back(dictionary.nameAt(entry(random)));
+        if (i % 2 == 1) {
+            queries.back() += 'q'; // A miss that shares its whole prefix with a hit
+        }
+    }
+
+    Word located;
+    std::size_t found = 0;
+    for (const std::string& query : queries) {
+        timings.time([&]() { found += dictionary.searchWordInDictionary(query, located) ? 1 : 0; });
+    }
+    timings.report("searchWordInDictionary");
+
+    std::size_t rhymes = 0;
+    for (std::size_t i = 0; i < queries.size(); i += 2) {
+        timings.time([&]() { rhymes += dictionary.findRhymingWords(queries[i]).size(); });
+    }
+    timings.report("findRhymingWords");
+
+    std::size_t palindromes = 0;
+    const char ranges[][2] = {{'A', 'C'}, {'D', 'F'}, {'G', 'I'}, {'J', 'L'}, {'M', 'O'}, {'P', 'R'}, {'S', 'U'}, {'V', 'X'}, {'Y', 'Z'}};
+    for (std::size_t i = 0; i < std::max<std::size_t>(9, queryCount / 100); ++i) {
+        const char* range = ranges[i % 9];
+        timings.time([&]() { palindromes += dictionary.findPalindromes(range[0], range[1]).size(); });
+    }
+    timings.report("findPalindromes");
+
+    std::size_t questions = 0;
+    ClozeIndex::Question question;
+    for (std::size_t i = 0; i < queryCount; ++i) {
+        const std::uint64_t draw = random();
+        timings.time([&]() { questions += dictionary.pickClozeQuestion(draw, question) ? 1 : 0; });
+    }
+    timings.report("pickClozeQuestion");
+
+    const std::string saved = filename + ".benchmark.tmp";
+    for (int run = 0; run < repeatCount; ++run) {
+        timings.time([&]() { dictionary.saveDictionaryToFile(saved); });
+    }
+    timings.report("saveDictionaryToFile", megabytes, "MiB");
+    std::remove(saved.c_str());
+
+    // Printed so the queries cannot be optimised away, and as a sanity check between runs
+    std::cout << found << " searches found, " << rhymes << " rhymes, " << palindromes << " palindromes, "
+              << questions << " questions\n";
+    return 0;
+}
@@ -0,0 +1,138 @@
+// File: GenerateDictionary.cpp
+// Summary:
+// This program writes a synthetic dictionary file in the "Type: / Definition: / Word: "
+// format, so the other benchmarks can be run at any size without the real dictionary file.
+//
+// Input:
+// - The number of entries (for example 10000 to 10000000), the file to write and an
+//   optional seed (default 1). The same arguments always produce the same file.
+//
+// Output:
+// - The dictionary file, and one line on standard output with its size.
+//
+// Comments:
+// - Names are made of consonant-vowel syllables: zero to two random syllables followed by
+//   the entry's number written as a fixed number of syllables, so every name is unique and
+//   names share endings (and therefore rhymes) the way real words do.
+// - About one entry in 200 is a palindrome. Palindromes have an odd length and every other
+//   name an even length, so they cannot collide with the other names.
+// - Definitions are 4 to 14 words drawn from a fixed vocabulary with a skewed distribution,
+//   so a few words are very common and most are rare, as in real definitions.
+//
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char consonants[] = "bcdfghjklmnprstvwxyz";
+const char vowels[] = "aeiou";
+const std::size_t syllableCount = (sizeof(consonants) - 1) * (sizeof(vowels) - 1);
+const char* const types[] = {"n", "n", "n", "v", "v", "adj", "adj", "adv", "prep"};
+
+void appendSyllable(std::size_t syllable, std::string& out) {
+    out += consonants[syllable / (sizeof(vowels) - 1)];
+    out += vowels[syllable % (sizeof(vowels) - 1)];
+}
+
+// Writes number as exactly digits syllables, least significant last
+void appendCode(std::size_t number, std::size_t digits, std::string& out) {
+    const std::size_t start = out.size();
+    out.append(digits * 2, ' ');
+    for (std::size_t d = digits; d-- > 0;) {
+        out[start + d * 2] = consonants[(number % syllableCount) / (sizeof(vowels) - 1)];
+        out[start + d * 2 + 1] = vowels[(number % syllableCount) % (sizeof(vowels) - 1)];
+        number /= syllableCount;
+    }
+}
+
+std::vector<std::string> makeVocabulary(std::mt19937_64& random, std::size_t size) {
+    std::vector<std::string> vocabulary;
+    std::uniform_int_distribution<std::size_t> syllable(0, syllableCount - 1);
+    std::uniform_int_distribution<int> length(1, 4);
+    for (std::size_t i = 0; i < size; ++i) {
+        std::string word;
+        for (int s = length(random); s > 0; --s) {
+            appendSyllable(syllable(random), word);
+        }
+        vocabulary.push_back(std::move(word));
+    }
+    return vocabulary;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 4) {
+        std::cerr << "Usage: " << argv[0] << " <entries> <output.txt> [seed]\n";
+        return 1;
+    }
+    const std::size_t entries = std::strtoull(argv[1], nullptr, 10);
+    const std::uint64_t seed = argc == 4 ? std::strtoull(argv[3], nullptr, 10) : 1;
+    if (entries == 0) {
+        std::cerr << "The number of entries must be positive.\n";
+        return 1;
+    }
+    std::FILE* file = std::fopen(argv[2], "wb");
+    if (file == nullptr) {
+        std::cerr << "Cannot write " << argv[2] << "\n";
+        return 1;
+    }
+
+    std::mt19937_64 random(seed);
+    const std::vector<std::string> vocabulary = makeVocabulary(random, 5000);
+    std::size_t digits = 1;
+    for (std::size_t capacity = syllableCount; capacity < entries; capacity *= syllableCount) {
+        ++digits;
+    }
+
+    std::uniform_int_distribution<std::size_t> syllable(0, syllableCount - 1);
+    std::uniform_int_distribution<int> prefixLength(0, 2);
+    std::uniform_int_distribution<int> definitionLength(4, 14);
+    std::uniform_int_distribution<std::size_t> type(0, sizeof(types) / sizeof(types[0]) - 1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    std::string buffer, name;
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < entries; ++i) {
+        name.clear();
+        if (i % 200 == 199) {
+            appendCode(i, digits, name);
+            const std::string half = name;
+            name.append(half.rbegin() + 1, half.rend()); // abc -> abcba
+        } else {
+            for (int p = prefixLength(random); p > 0; --p) {
+                appendSyllable(syllable(random), name);
+            }
+            appendCode(i, digits, name);
+        }
+
+        buffer.append("Type: ").append(types[type(random)]).append("\nDefinition: ");
+        for (int w = definitionLength(random); w > 0; --w) {
+            const double skewed = unit(random);
+            buffer.append(vocabulary[static_cast<std::size_t>(skewed * skewed * skewed * vocabulary.size())]);
+            buffer += w > 1 ? ' ' : '.';
+        }
+        buffer.append("\nWord: ").append(name).append("\n\n");
+
+        if (buffer.size() >= (1 << 20) || i + 1 == entries) {
+            if (std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+                std::cerr << "Failed to write " << argv[2] << "\n";
+                std::fclose(file);
+                return 1;
+            }
+            written += buffer.size();
+            buffer.clear();
+        }
+    }
+    if (std::fclose(file) != 0) {
+        std::cerr << "Failed to write " << argv[2] << "\n";
+        return 1;
+    }
+    std::cout << "Wrote " << entries << " entries (" << written / 1024 << " KiB) to " << argv[2] << "\n";
+    return 0;
+}
@@ -0,0 +1,76 @@
+// File: StorageBenchmark.cpp
+// Summary:
+// This program compares the storage layouts of the Dictionary class on one file: the
+// original std::vector<Word>, the WordStore columns, and the columns with compressed
+// definitions. For each layout it loads the file and reports the load time, the heap
+// allocations made while loading, the bytes held by the entries, the time of a name-only
+// scan (a palindrome check of every name) and the time of reading definitions at random
+// positions, which is what compression slows down.
+//
+// Input:
+// - The dictionary file to load, given as the only command line argument.
+//
+// Output:
+// - One line per layout on standard output.
+//
+#include "../ImprovedDictionary.h"
+#include "AllocationCounter.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void measure(const char* label, StorageMode mode, const std::string& filename) {
+    ImprovedDictionary dictionary;
+    dictionary.setStorageMode(mode);
+
+    const AllocationStats before = allocationStats();
+    const auto loadStart = std::chrono::steady_clock::now();
+    if (!dictionary.loadFile(filename)) {
+        return;
+    }
+    const double loadTime = millisecondsSince(loadStart);
+    const AllocationStats loading = allocationStats() - before;
+
+    const auto scanStart = std::chrono::steady_clock::now();
+    std::size_t palindromes = 0;
+    for (std::size_t i = 0; i < dictionary.wordCount(); ++i) {
+        palindromes += dictionary.isPalindrome(dictionary.nameAt(i)) ? 1 : 0;
+    }
+    const double scanTime = millisecondsSince(scanStart);
+
+    const std::size_t reads = 100000;
+    std::uint64_t position = 1, definitionBytes = 0;
+    const auto readStart = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < reads && dictionary.wordCount() > 0; ++i) {
+        position = position * 6364136223846793005ull + 1442695040888963407ull; // A fixed sequence, the same for every layout
+        definitionBytes += dictionary.definitionAt((position >> 33) % dictionary.wordCount()).size();
+    }
+    const double readTime = millisecondsSince(readStart);
+
+    std::cout << label << ": " << dictionary.wordCount() << " entries"
+              << ", load " << loadTime << " ms"
+              << ", " << loading.allocations << " allocations (" << loading.bytes / 1024 << " KiB requested)"
+              << ", entries hold " << dictionary.storageMemoryUsage() / 1024 << " KiB"
+              << ", name scan " << scanTime << " ms (" << palindromes << " palindromes)"
+              << ", " << reads << " random definitions " << readTime << " ms (" << definitionBytes / 1024 << " KiB)\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <dictionary.txt>\n";
+        return 1;
+    }
+
+    measure("std::vector<Word>", StorageMode::Words, argv[1]);
+    measure("WordStore columns", StorageMode::Compact, argv[1]);
+    measure("Compressed definitions", StorageMode::Compressed, argv[1]);
+    return 0;
+}
@@ -0,0 +1,72 @@
+// File: TokenizerBenchmark.cpp
+// Summary:
+// This program measures how fast every definition of a dictionary can be split into words:
+// with std::istringstream and std::string tokens (how countWordsInDefinition and
+// splitDefinitionIntoWords used to work), and with the Tokenizer's count and split.
+// Build it once as usual (SSE2) and once with -mavx2 to compare the two instruction sets.
+//
+// Input:
+// - The dictionary file to load, given as the only command line argument.
+//
+// Output:
+// - One line per method with the time per pass and the throughput in MB/s.
+//
+#include "../ImprovedDictionary.h"
+#include "../Tokenizer.h"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+template <typename Pass>
+void measure(const char* label, const Dictionary& dictionary, std::size_t bytes, Pass pass) {
+    const int repetitions = 5;
+    std::size_t tokens = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        tokens = 0;
+        for (std::size_t i = 0; i < dictionary.wordCount(); ++i) {
+            tokens += pass(dictionary.definitionAt(i));
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / repetitions;
+    std::cout << label << ": " << tokens << " tokens, " << seconds * 1000 << " ms per pass, "
+              << bytes / seconds / 1e6 << " MB/s\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <dictionary.txt>\n";
+        return 1;
+    }
+
+    Dictionary dictionary;
+    dictionary.setStorageMode(StorageMode::Compact);
+    if (!dictionary.loadFile(argv[1])) {
+        return 1;
+    }
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < dictionary.wordCount(); ++i) {
+        bytes += dictionary.definitionAt(i).size();
+    }
+
+    measure("istringstream split", dictionary, bytes, [](std::string_view definition) {
+        std::istringstream stream{std::string(definition)};
+        std::vector<std::string> words;
+        std::string word;
+        while (stream >> word) {
+            words.push_back(word);
+        }
+        return words.size();
+    });
+    measure("Tokenizer::count", dictionary, bytes, [](std::string_view definition) { return Tokenizer::count(definition); });
+    std::vector<std::string_view> tokens;
+    measure("Tokenizer::split", dictionary, bytes, [&tokens](std::string_view definition) {
+        Tokenizer::split(definition, tokens);
+        return tokens.size();
+    });
+    return 0;
+}
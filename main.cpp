@@ -9,6 +9,17 @@
 // Input:
 // The program takes input from the user when interacting with
 // the dictionary menu.
+// Run as "dictionary_program --compile <dictionary.txt> <dictionary.snap>" it instead compiles a
+// text dictionary into a binary snapshot that the menu's "Choose file" option can load instantly.
+// Run as "dictionary_program --stream <dictionary file>" it answers newline separated queries
+// from standard input without prompts, for batch jobs and pipes (see QueryProcessor.h).
+// Run as "dictionary_program --serve <dictionary file> <socket path | port>" it answers the same
+// queries for any number of local clients over a Unix domain socket, or over 127.0.0.1:port when
+// the last argument is a number, and reloads the file whenever it changes (see QueryServer.h).
+// Any of these may be preceded by "--metrics <file>", which records timings of the dictionary
+// operations and writes them to file in the Prometheus text format on SIGUSR1 and on exit
+// (see Metrics.h), and then by "--compressed", which keeps the definitions of text
+// dictionaries compressed in memory (StorageMode::Compressed).
 //
 // Output:
 // The program provides output to the console based on user interaction with the menu and the functions they invoke interacting
@@ -24,9 +35,128 @@
 // - Error handling and user prompts are included to guide the user through the program.
 //
 #include "ImprovedDictionary.h"
+#include "Metrics.h"
+#include "QueryProcessor.h"
+#include "QueryServer.h"
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+QueryServer* runningServer = nullptr;
+
+extern "C" void stopServer(int) { // Ctrl-C or kill stops the server cleanly, removing its socket
+    if (runningServer != nullptr) {
+        runningServer->stop();
+    }
+}
+
+struct MetricsFile { // Writes the metrics a last time however main returns
+    std::string path;
+
+    ~MetricsFile() {
+        if (!path.empty()) {
+            Metrics::stopDumping();
+            if (!Metrics::writePrometheusFile(path)) {
+                std::cerr << "Failed to write metrics to " << path << "\n";
+            }
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) { // The main function initializes an ImprovedDictionary object. Then calls the menu function
+    MetricsFile metrics;
+    if (argc > 2 && std::string(argv[1]) == "--metrics") {
+        metrics.path = argv[2];
+        Metrics::enable(true);
+#ifdef SIGUSR1
+        Metrics::dumpOnSignal(SIGUSR1, metrics.path);
+#endif
+        argv[2] = argv[0]; // Drop the option, the rest is parsed as usual
+        argv += 2;
+        argc -= 2;
+    }
 
-int main() { // The main function initializes an ImprovedDictionary object. Then calls the menu function
     ImprovedDictionary dictionary;
+    if (argc > 1 && std::string(argv[1]) == "--compressed") {
+        dictionary.setStorageMode(StorageMode::Compressed);
+        argv[1] = argv[0];
+        ++argv;
+        --argc;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--compile") { // Compile step: text dictionary -> snapshot, no menu
+        if (argc != 4) {
+            std::cerr << "Usage: " << argv[0] << " --compile <dictionary.txt> <dictionary.snap>\n";
+            return 1;
+        }
+        if (!dictionary.loadDictionaryFromFile(argv[2]) || !dictionary.compileSnapshot(argv[3])) {
+            std::cerr << "Failed to compile snapshot.\n";
+            return 1;
+        }
+        std::cout << "Snapshot written to " << argv[3] << "\n";
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--stream") { // Streaming step: queries on stdin, answers on stdout, no menu
+        if (argc != 3) {
+            std::cerr << "Usage: " << argv[0] << " --stream <dictionary file>\n";
+            return 1;
+        }
+        dictionary.setLoadThreads(0);
+        if (!dictionary.loadDictionaryFromFile(argv[2])) {
+            std::cerr << "Failed to load " << argv[2] << "\n";
+            return 1;
+        }
+        QueryProcessor processor(dictionary);
+        if (!processor.run(fileno(stdin), fileno(stdout))) {
+            std::cerr << "Failed to read queries or write answers.\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--serve") { // Server step: queries from local clients, no menu
+        if (argc != 4) {
+            std::cerr << "Usage: " << argv[0] << " --serve <dictionary file> <socket path | port>\n";
+            return 1;
+        }
+        if (!dictionary.loadDictionaryFromFile(argv[2])) {
+            std::cerr << "Failed to load " << argv[2] << "\n";
+            return 1;
+        }
+        ConcurrentDictionary served(dictionary);
+        dictionary = ImprovedDictionary(); // The served copies are all that is needed now
+        if (!served.watchFile(argv[2])) {
+            std::cerr << "Cannot watch " << argv[2] << "; it will not be reloaded when it changes.\n";
+        }
+
+        QueryServer server(served);
+        const std::string where = argv[3];
+        const bool isPort = !where.empty() && where.find_first_not_of("0123456789") == std::string::npos;
+        if (isPort && (where.size() > 5 || std::atoi(where.c_str()) > 65535)) {
+            std::cerr << "Port out of range: " << where << "\n";
+            return 1;
+        }
+        if (isPort ? !server.listenTcp(static_cast<unsigned short>(std::atoi(where.c_str()))) : !server.listenUnix(where)) {
+            return 1;
+        }
+        runningServer = &server;
+        std::signal(SIGINT, stopServer);
+        std::signal(SIGTERM, stopServer);
+        std::cerr << "Serving " << argv[2] << " on " << (isPort ? "127.0.0.1:" : "") << where << "\n";
+        const bool finished = server.run(std::max(1u, std::thread::hardware_concurrency()));
+        runningServer = nullptr;
+        std::cerr << "Answered " << server.queryCount() << " queries.\n";
+        return finished ? 0 : 1;
+    }
 
     dictionary.menu();
 